@@ -0,0 +1,118 @@
+/* Check: acceleration sensors with control decimation (STEP n).
+ *
+ * A free-falling two-body robot with one acceleration sensor is run by the
+ * TCPController, fed with a scripted client that subscribes to the accel
+ * channel and sends 'STEP 1' or 'STEP 10'. In free fall the sensor must
+ * read zero no matter how many physics steps lie between two status
+ * messages. Exits with failure if the readings differ.
+ *
+ * Build the headless simulator sources with the check and run it from
+ * the repository root, the simulator's messages can be discarded:
+ *   g++ -O2 -std=c++1z -DSIMLOID_HEADLESS -Isrc bench/accel_step.cpp \
+ *       $(find src -name '*.cpp' ! -name main.cpp ! -name x11.cpp ! -name drawstuff.cpp) \
+ *       /usr/local/lib/libode.a -lpthread -lrt -o accel_step
+ *   ./accel_step 2>&1 >/dev/null
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <basic/configuration.h>
+#include <build/physics.h>
+#include <build/robot.h>
+#include <build/obstacles.h>
+#include <build/heightfield.h>
+#include <controller/tcp_controller.h>
+#include <misc/camera.h>
+
+Configuration global_conf = Configuration();
+
+namespace {
+
+/* plays the client's messages and keeps the replies */
+class ScriptTransport : public Transport {
+public:
+    ScriptTransport(std::string const& script) : script(script), pos(0) {}
+
+    bool establish_connection(void) { return true; }
+    bool send_message(const std::string& msg) { replies.push_back(msg); return true; }
+
+    std::vector<std::string> replies;
+
+protected:
+    std::size_t receive(char* dest, std::size_t max) {
+        const std::size_t n = std::min(max, script.size() - pos);
+        memcpy(dest, script.data() + pos, n);
+        pos += n;
+        return n;
+    }
+
+private:
+    const std::string script;
+    std::size_t pos;
+};
+
+/* z-component of the acceleration sensor in the last status message */
+double free_fall_accel(unsigned int steps_per_control)
+{
+    physics   universe;
+    Robot     robot(universe.world, universe.space);
+    Obstacle  obstacles(universe.world, universe.space, universe.static_space);
+    Landscape landscape(universe.static_space);
+    Camera    camera;
+
+    /* high above the ground, it falls less than 2 m during the check */
+    robot.create_box("upper", 0, 0, 10.2, .1, .1, .1, 0.1, 0, colors::white, true);
+    robot.create_box("lower", 0, 0, 10.0, .1, .1, .1, 0.1, 0, colors::white, true);
+    robot.connect_joint("upper", "lower", 0, 0, .1, 'x', -90, 90, 0, normal, "hinge");
+    robot.attach_accel_sensor("lower");
+
+    std::string script = "SUBSCRIBE accel\nSTEP " + std::to_string(steps_per_control) + "\nDONE\n";
+    const unsigned int cycles = 50 / steps_per_control;
+    for (unsigned int i = 0; i < cycles; ++i)
+        script += "DONE\n";
+    script += "EXIT\n";
+
+    double simtime = 0.0;
+    auto set_time = [&simtime](double t) { simtime = t; };
+    auto step     = [&]() { universe.step(global_conf.step_length); simtime += global_conf.step_length; };
+
+    ScriptTransport* client = new ScriptTransport(script); // owned by the controller
+    TCPController controller(global_conf, universe, robot, obstacles, landscape, set_time, step, camera);
+    if (not controller.establishConnection(client))
+        return NAN;
+
+    do step(); while (controller.control(simtime));
+
+    double a[3] = { NAN, NAN, NAN };
+    if (3 != sscanf(client->replies.back().c_str(), "%lf %lf %lf", &a[0], &a[1], &a[2]))
+        return NAN;
+    return a[2];
+}
+
+} // namespace
+
+int main(void)
+{
+    dInitODE();
+
+    global_conf.disable_graphics = true;
+    global_conf.initial_gravity  = true;
+
+    const double step_1  = free_fall_accel(1);
+    const double step_10 = free_fall_accel(10);
+    dCloseODE();
+
+    fprintf(stderr, "free fall, accel z: STEP 1 %+.4f, STEP 10 %+.4f\n", step_1, step_10);
+
+    const double tolerance = 1e-3;
+    if (not (std::fabs(step_1) < tolerance and std::fabs(step_10 - step_1) < tolerance)) {
+        fprintf(stderr, "FAILED: the accel reading depends on STEP.\n");
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "OK\n");
+    return EXIT_SUCCESS;
+}
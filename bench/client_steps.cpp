@@ -0,0 +1,82 @@
+/* Benchmark: control steps per second of the client library against a
+ * running simloid server.
+ *
+ * Each phase runs the closed control loop (receive status, compute voltages,
+ * send) with the text protocol, the binary protocol and the compressed binary
+ * protocol, on one connection. The voltages hold the default position with a
+ * P-controller, as in simloid_client.py.
+ *
+ * Build and run from the repository root, with a server started e.g. by
+ * './simloid --nographics --norealtime --port 7000 --robot 31':
+ *   g++ -O2 -std=c++1z -Isrc bench/client_steps.cpp client/simloid_client.cpp -o bench_client
+ *   ./bench_client [<port> | <unix socket path> | shm:<name>] [steps]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../client/simloid_client.h"
+
+namespace {
+
+bool run(simloid::Client& client, const char* name, unsigned int steps)
+{
+    auto const& traits = client.traits();
+    std::vector<double> voltages(traits.num_joints);
+    std::size_t values = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int s = 0; s < steps; ++s)
+    {
+        if (not client.receive()) return false;
+
+        const double* status = client.status(); // time, positions, ...
+        values += client.status_count();
+        for (std::size_t i = 0; i < traits.num_joints; ++i)
+            voltages[i] = 5.0 * (traits.joint_default[i] - status[1 + i]);
+
+        if (not client.set_voltages(voltages.data(), voltages.size()) or not client.send())
+            return false;
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+
+    printf("%-20s %8u steps  %10.0f steps/s  %8.2f us/step  %6.1f values/status\n",
+           name, steps, steps / seconds, 1e6 * seconds / steps, double(values) / steps);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const char*        target = (argc > 1) ? argv[1] : "7000";
+    const unsigned int steps  = (argc > 2) ? atoi(argv[2]) : 20000;
+
+    simloid::Client client;
+    const bool connected = (0 == strncmp(target, "shm:", 4)) ? client.connect_shm(target + 4)
+                         : strchr(target, '/')               ? client.connect_unix(target)
+                                                             : client.connect_tcp("127.0.0.1", atoi(target));
+    if (not connected) {
+        printf("ERROR: %s\n", client.error().c_str());
+        return EXIT_FAILURE;
+    }
+    printf("robot: %lu joints, %lu bodies, %lu accels, action delay %u\n",
+           client.traits().num_joints, client.traits().num_bodies, client.traits().num_accels, client.traits().action_delay);
+
+    bool ok = run(client, "text", steps);
+
+    client.use_binary(true);
+    ok = ok and client.send() and client.receive() and run(client, "binary", steps);
+
+    client.use_compression(1e-4);
+    ok = ok and client.send() and client.receive() and run(client, "binary compressed", steps);
+
+    if (not ok) {
+        printf("ERROR: %s\n", client.error().c_str());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
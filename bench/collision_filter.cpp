@@ -0,0 +1,136 @@
+/* Benchmark: the collision filter (category and collide bits) in ODE's
+ * broadphase.
+ *
+ * Every robot walks an open-loop gait (position control, sine waves shifted
+ * from joint to joint) in scenes 0 to 6, once with all bits set on every
+ * geom (no filter, the former behaviour) and once with the filter as built.
+ * Reported are the pairs passed to near_callback and the contacts created
+ * per step, the time of dSpaceCollide per step, the physics steps per second
+ * and how far the filtered run ends from the unfiltered one. Robots without
+ * self-collision should keep their contacts and end where they did.
+ *
+ * Build the headless simulator sources with the benchmark and run it from
+ * the repository root, the simulator's messages can be discarded:
+ *   g++ -O2 -std=c++1z -DSIMLOID_HEADLESS -Isrc bench/collision_filter.cpp \
+ *       $(find src -name '*.cpp' ! -name main.cpp ! -name x11.cpp ! -name drawstuff.cpp) \
+ *       /usr/local/lib/libode.a -lpthread -lrt -o bench_filter
+ *   ./bench_filter [seconds] 2>&1 >/dev/null
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <basic/configuration.h>
+#include <build/bioloid.h>
+#include <build/physics.h>
+#include <build/robot.h>
+#include <build/obstacles.h>
+#include <build/heightfield.h>
+
+Configuration global_conf = Configuration();
+
+namespace {
+
+struct Result {
+    double pairs = 0.0;            // per step
+    double contacts = 0.0;         // per step
+    double collide_us = 0.0;       // per step
+    double steps_per_second = 0.0;
+    Vector3 end;                   // of the robot's first body
+    bool   self_collision = false;
+};
+
+/* every geom collides with everything, as without the filter */
+void disable_filter(dSpaceID space)
+{
+    collision::set_filter((dGeomID) space, collision::all, collision::all);
+    for (int i = 0; i < dSpaceGetNumGeoms(space); ++i) {
+        const dGeomID g = dSpaceGetGeom(space, i);
+        if (dGeomIsSpace(g)) disable_filter((dSpaceID) g);
+        else collision::set_filter(g, collision::all, collision::all);
+    }
+}
+
+Result run(int robot_id, int scene, bool filter, unsigned int steps)
+{
+    global_conf.scene = scene;
+
+    srand(1); // same scene for both runs
+    physics   universe;
+    Robot     robot(universe.world, universe.space);
+    Obstacle  obstacles(universe.world, universe.space, universe.static_space);
+    Landscape landscape(universe.static_space);
+    Bioloid::create_robot(robot, robot_id, std::vector<double>{});
+    Bioloid::create_scene(obstacles, landscape);
+    universe.fit_space(global_conf);
+
+    if (not filter) disable_filter(universe.space);
+
+    double collide = 0.0, busy = 0.0;
+    for (unsigned int s = 0; s < steps; ++s) {
+        const double t = s * global_conf.step_length;
+        for (std::size_t j = 0; j < robot.number_of_joints(); ++j)
+            robot.joints[j].set_position(0.3 * std::sin(constants::t_pi * t + 0.8 * j));
+
+        /* physics::step, timed in two parts */
+        const auto begin = std::chrono::steady_clock::now();
+        robot.joints.apply_control_all();
+        dSpaceCollide(universe.space, &universe, &near_callback);
+        const auto collided = std::chrono::steady_clock::now();
+        dWorldStep(universe.world, global_conf.step_length);
+        dJointGroupEmpty(universe.contactgroup);
+        const auto end = std::chrono::steady_clock::now();
+
+        collide += std::chrono::duration<double>(collided - begin).count();
+        busy    += std::chrono::duration<double>(end - begin).count();
+    }
+
+    Result result;
+    result.pairs            = double(universe.collision_pairs) / steps;
+    result.contacts         = double(universe.contacts) / steps;
+    result.collide_us       = 1e6 * collide / steps;
+    result.steps_per_second = steps / busy;
+    result.end              = robot.bodies[0].get_position();
+    result.self_collision   = robot.has_self_collision();
+    return result;
+}
+
+void print(const char* filter, Result const& r, Result const& reference, int robot_id, int scene)
+{
+    fprintf(stderr, "%5d %5d  %-4s %-4s %8.1f %9.1f %13.1f %10.0f %7.2fx %9.4f\n"
+           , robot_id, scene, r.self_collision ? "on" : "off", filter
+           , r.pairs, r.contacts, r.collide_us
+           , r.steps_per_second, r.steps_per_second / reference.steps_per_second
+           , distance(r.end, reference.end));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    dInitODE();
+
+    const double seconds = (argc > 1) ? atof(argv[1]) : 5.0;
+    global_conf.disable_graphics = true;
+
+    const unsigned int steps = seconds / global_conf.step_length;
+
+    /* all robots without random model parameters */
+    const int robots[] = { 10, 11, 20, 30, 31, 32, 33, 34, 60, 80, 90, 91, 92, 93, 94 };
+    const int num_scenes = 7;
+
+    fprintf(stderr, "%.1f s simulated per run, collision space '%s'\n", seconds, global_conf.collision_space.c_str());
+    fprintf(stderr, "robot scene  self filter  pairs  contacts  collide [us]    steps/s  speedup  drift [m]\n");
+
+    for (int robot_id : robots)
+        for (int scene = 0; scene < num_scenes; ++scene) {
+            const Result before = run(robot_id, scene, false, steps);
+            const Result after  = run(robot_id, scene, true , steps);
+            print("off", before, before, robot_id, scene);
+            print("on" , after , before, robot_id, scene);
+        }
+    dCloseODE();
+    return 0;
+}
@@ -0,0 +1,129 @@
+/* Benchmark: collision detection with the different collision spaces.
+ *
+ * For scenes 1 to 6 a robot walks an open-loop gait (position control, sine
+ * waves shifted from joint to joint) for a few seconds, with the geoms in
+ *   flat      one hash space with ODE's default levels (the former layout),
+ *   hash      hash spaces with levels fitted to the geom sizes,
+ *   sap       sweep and prune spaces,
+ *   quadtree  quadtree spaces spanning the scene,
+ * the latter three with the ground, heightfields and fixed obstacles in a
+ * nested static space. Reported are the time of dSpaceCollide per step,
+ * the physics steps per second and how far the robot ends from the flat
+ * run (the order of the contacts differs between the spaces).
+ *
+ * Build the headless simulator sources with the benchmark and run it from
+ * the repository root, the simulator's messages can be discarded:
+ *   g++ -O2 -std=c++1z -DSIMLOID_HEADLESS -Isrc bench/collision_spaces.cpp \
+ *       $(find src -name '*.cpp' ! -name main.cpp ! -name x11.cpp ! -name drawstuff.cpp) \
+ *       /usr/local/lib/libode.a -lpthread -lrt -o bench_spaces
+ *   ./bench_spaces [robot] [seconds] 2>&1 >/dev/null
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <basic/configuration.h>
+#include <build/bioloid.h>
+#include <build/physics.h>
+#include <build/robot.h>
+#include <build/obstacles.h>
+#include <build/heightfield.h>
+
+Configuration global_conf = Configuration();
+
+namespace {
+
+struct Result {
+    double collide_us = 0.0;       // per step
+    double steps_per_second = 0.0;
+    Vector3 end;                   // of the robot's first body
+};
+
+/* the former layout: all geoms in one hash space with default levels */
+void flatten(physics& universe)
+{
+    dSpaceRemove(universe.space, (dGeomID) universe.static_space);
+    while (dSpaceGetNumGeoms(universe.static_space) > 0) {
+        const dGeomID g = dSpaceGetGeom(universe.static_space, 0);
+        dSpaceRemove(universe.static_space, g);
+        dSpaceAdd(universe.space, g);
+    }
+    dHashSpaceSetLevels(universe.space, -3, 10);
+}
+
+Result run(int robot_id, int scene, std::string const& layout, unsigned int steps)
+{
+    global_conf.scene           = scene;
+    global_conf.collision_space = (layout == "flat") ? "hash" : layout;
+
+    srand(1); // same scene for all layouts
+    physics   universe;
+    Robot     robot(universe.world, universe.space);
+    Obstacle  obstacles(universe.world, universe.space, universe.static_space);
+    Landscape landscape(universe.static_space);
+    Bioloid::create_robot(robot, robot_id, std::vector<double>{});
+    Bioloid::create_scene(obstacles, landscape);
+
+    if (layout == "flat") flatten(universe);
+    else universe.fit_space(global_conf);
+
+    Result result;
+    double collide = 0.0, busy = 0.0;
+    for (unsigned int s = 0; s < steps; ++s) {
+        const double t = s * global_conf.step_length;
+        for (std::size_t j = 0; j < robot.number_of_joints(); ++j)
+            robot.joints[j].set_position(0.3 * std::sin(constants::t_pi * t + 0.8 * j));
+
+        /* physics::step, timed in two parts */
+        const auto begin = std::chrono::steady_clock::now();
+        robot.joints.apply_control_all();
+        dSpaceCollide(universe.space, &universe, &near_callback);
+        const auto collided = std::chrono::steady_clock::now();
+        dWorldStep(universe.world, global_conf.step_length);
+        dJointGroupEmpty(universe.contactgroup);
+        const auto end = std::chrono::steady_clock::now();
+
+        collide += std::chrono::duration<double>(collided - begin).count();
+        busy    += std::chrono::duration<double>(end - begin).count();
+    }
+    if (layout == "flat") dSpaceAdd(universe.space, (dGeomID) universe.static_space); // destroyed with the space
+
+    result.collide_us       = 1e6 * collide / steps;
+    result.steps_per_second = steps / busy;
+    result.end              = robot.bodies[0].get_position();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    dInitODE();
+
+    const int    robot_id = (argc > 1) ? atoi(argv[1]) : 31;
+    const double seconds  = (argc > 2) ? atof(argv[2]) : 5.0;
+    global_conf.disable_graphics = true;
+
+    const unsigned int steps = seconds / global_conf.step_length;
+    const char* layouts[] = { "flat", "hash", "sap", "quadtree" };
+
+    fprintf(stderr, "robot %d, %.1f s simulated per run\n", robot_id, seconds);
+    fprintf(stderr, "scene  space      collide [us]  speedup    steps/s  end vs. flat [m]\n");
+
+    for (int scene = 1; scene <= 6; ++scene) {
+        Result flat;
+        for (const char* layout : layouts) {
+            const Result r = run(robot_id, scene, layout, steps);
+            if (std::string(layout) == "flat") flat = r;
+
+            fprintf(stderr, "%5d  %-9s %13.1f %7.2fx %10.0f %17.4f\n"
+                   , scene, layout, r.collide_us, flat.collide_us / r.collide_us
+                   , r.steps_per_second, distance(r.end, flat.end));
+        }
+    }
+    dCloseODE();
+    return 0;
+}
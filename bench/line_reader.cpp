@@ -0,0 +1,156 @@
+/* Benchmark: splitting the received command stream into lines.
+ *
+ * Compares the former reader (8 KiB chunks appended to a std::string, each
+ * line erased from its front) with the receive buffer of Transport, which
+ * hands out views into the buffer. The stream is read from a capture file
+ * (e.g. recorded with 'tcpflow') or, without argument, two streams are
+ * generated: control messages "UX ...\nTX ...\nDONE\n" for a batch of 16
+ * robots with 32 joints, and many short per-joint UI and TI commands.
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=c++1z -Isrc bench/line_reader.cpp src/communication/transport.cpp -o bench_lines
+ *   ./bench_lines [capture_file]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <communication/transport.h>
+
+namespace {
+
+/* replays the captured stream in reads of at most packet_size bytes */
+class ReplayTransport : public Transport {
+public:
+    ReplayTransport(std::string const& stream, std::size_t packet_size) : stream(stream), packet_size(packet_size), pos(0) {}
+    bool establish_connection(void) { return true; }
+    bool send_message(const std::string&) { return true; }
+private:
+    std::size_t receive(char* dest, std::size_t max) {
+        const std::size_t n = std::min({max, packet_size, stream.size() - pos});
+        memcpy(dest, stream.data() + pos, n);
+        pos += n;
+        return n; // 0 at the end of the stream, the reader then sees "EXIT"
+    }
+    std::string const& stream;
+    std::size_t packet_size, pos;
+};
+
+/* the former Transport::getNextLine with SocketServer::getNextMessage */
+class FormerReader {
+public:
+    FormerReader(std::string const& stream, std::size_t packet_size) : stream(stream), packet_size(packet_size), pos(0) {}
+
+    std::string getNextLine() {
+        std::string::size_type p;
+        while ((p = receivedStream.find("\n", 0)) == std::string::npos)
+            receivedStream += getNextMessage();
+        std::string ret = receivedStream.substr(0, p);
+        receivedStream.erase(0, p+1);
+        return ret;
+    }
+private:
+    std::string getNextMessage() {
+        #define MSGLEN 8192
+        char buffer[MSGLEN];
+        memset(buffer, 0, MSGLEN);
+        const std::size_t n = std::min({std::size_t(MSGLEN), packet_size, stream.size() - pos});
+        if (0 == n) return std::string("EXIT\n");
+        memcpy(buffer, stream.data() + pos, n);
+        pos += n;
+        return std::string(buffer, n);
+    }
+    std::string const& stream;
+    std::size_t packet_size, pos;
+    std::string receivedStream;
+};
+
+std::string generate_batched_stream(unsigned int num_messages, unsigned int num_values)
+{
+    char tmp[32];
+    std::string stream;
+    for (unsigned int m = 0; m < num_messages; ++m) {
+        for (const char* cmd : {"UX", "TX"}) {
+            stream.append(cmd);
+            for (unsigned int i = 0; i < num_values; ++i) {
+                snprintf(tmp, sizeof(tmp), " %lf", 0.001 * ((m + i) % 1000));
+                stream.append(tmp);
+            }
+            stream.append("\n");
+        }
+        stream.append("DONE\n");
+    }
+    return stream;
+}
+
+std::string generate_per_joint_stream(unsigned int num_messages, unsigned int num_joints)
+{
+    char tmp[64];
+    std::string stream;
+    for (unsigned int m = 0; m < num_messages; ++m) {
+        for (unsigned int i = 0; i < num_joints; ++i) {
+            snprintf(tmp, sizeof(tmp), "UI %u %lf\nTI %u 0.500000\n", i, 0.001 * ((m + i) % 1000), i);
+            stream.append(tmp);
+        }
+        stream.append("DONE\n");
+    }
+    return stream;
+}
+
+template <typename Reader>
+double run(Reader& reader, std::size_t& lines, std::size_t& bytes)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (;;) {
+        const auto line = reader.getNextLine();
+        if (line == "EXIT") break;
+        ++lines;
+        bytes += line.size();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void compare(const char* name, std::string const& stream)
+{
+    printf("\n%s: %lu bytes\n", name, stream.size());
+    printf("packet [B]   former [ms]   buffer [ms]   speedup\n");
+
+    for (std::size_t packet_size : {1500, 8192, 65536, 1 << 20})
+    {
+        std::size_t lines_old = 0, bytes_old = 0, lines_new = 0, bytes_new = 0;
+
+        FormerReader former(stream, packet_size);
+        const double t_old = run(former, lines_old, bytes_old);
+
+        ReplayTransport transport(stream, packet_size);
+        const double t_new = run(transport, lines_new, bytes_new);
+
+        if (lines_old != lines_new or bytes_old != bytes_new) {
+            printf("ERROR: readers disagree (%lu/%lu lines, %lu/%lu bytes).\n", lines_old, lines_new, bytes_old, bytes_new);
+            exit(EXIT_FAILURE);
+        }
+        printf("%10lu   %11.2f   %11.2f   %6.2fx\n", packet_size, t_old, t_new, t_old / t_new);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (not file) { printf("ERROR: can not read '%s'.\n", argv[1]); return EXIT_FAILURE; }
+        compare(argv[1], std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    }
+    else {
+        compare("batched UX/TX", generate_batched_stream(2000, 16 * 32));
+        compare("per-joint UI/TI", generate_per_joint_stream(20000, 32));
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/* Benchmark: dWorldStep against dWorldQuickStep for each robot and scene.
+ *
+ * Every robot walks the same open-loop gait (position control, sine waves
+ * shifted from joint to joint) in every scene, once with each solver, in
+ * fresh worlds built with the same random seed. Reported are the physics
+ * steps per second, the joint error (distance between the two anchors of a
+ * hinge, as seen from either body, mean and max over the run) and the
+ * distance the robot travelled. 'drift' is how far the QuickStep run ends
+ * from the dWorldStep run, a large drift means the gait result changes with
+ * the solver.
+ *
+ * Build the headless simulator sources with the benchmark and run it from
+ * the repository root, the simulator's messages can be discarded:
+ *   g++ -O2 -std=c++1z -DSIMLOID_HEADLESS -Isrc bench/solvers.cpp \
+ *       $(find src -name '*.cpp' ! -name main.cpp ! -name x11.cpp ! -name drawstuff.cpp) \
+ *       /usr/local/lib/libode.a -lpthread -lrt -o bench_solvers
+ *   ./bench_solvers [seconds] [iterations] [SOR] 2>&1 >/dev/null
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <basic/configuration.h>
+#include <controller/batch.h>
+
+Configuration global_conf = Configuration();
+
+namespace {
+
+struct Result {
+    double steps_per_second = 0.0;
+    double joint_error_mean = 0.0; // m
+    double joint_error_max  = 0.0; // m
+    Vector3 start, end;            // of the robot's first body
+    bool   diverged = false;
+};
+
+/* worst anchor mismatch of all hinges attached to the robot */
+double joint_error(Robot const& robot)
+{
+    double error = 0.0;
+    for (std::size_t i = 0; i < robot.number_of_bodies(); ++i) {
+        const dBodyID body = robot.bodies[i].body;
+        for (int j = 0; j < dBodyGetNumJoints(body); ++j) {
+            const dJointID joint = dBodyGetJoint(body, j);
+            if (dJointGetType(joint) != dJointTypeHinge) continue;
+
+            dVector3 a1, a2;
+            dJointGetHingeAnchor (joint, a1);
+            dJointGetHingeAnchor2(joint, a2);
+            error = std::max(error, std::sqrt( (a1[0]-a2[0])*(a1[0]-a2[0])
+                                             + (a1[1]-a2[1])*(a1[1]-a2[1])
+                                             + (a1[2]-a2[2])*(a1[2]-a2[2]) ));
+        }
+    }
+    return error;
+}
+
+Result run(int robot_id, int scene, bool quick, unsigned int steps)
+{
+    global_conf.scene      = scene;
+    global_conf.quick_step = quick;
+
+    srand(1); // same scene for both solvers
+    BatchInstance world(global_conf, robot_id, std::vector<double>{});
+    Robot& robot = world.get_robot();
+
+    Result result;
+    result.start = robot.bodies[0].get_position();
+
+    double error_sum = 0.0;
+    double busy = 0.0;
+    for (unsigned int s = 0; s < steps and not result.diverged; ++s) {
+        const double t = s * global_conf.step_length;
+        for (std::size_t j = 0; j < robot.number_of_joints(); ++j)
+            robot.joints[j].set_position(0.3 * std::sin(constants::t_pi * t + 0.8 * j));
+
+        const auto begin = std::chrono::steady_clock::now();
+        world.step(1, global_conf.step_length);
+        busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        const double error = joint_error(robot);
+        error_sum += error;
+        result.joint_error_max = std::max(result.joint_error_max, error);
+        result.diverged = has_diverged(robot);
+    }
+
+    result.steps_per_second = steps / busy;
+    result.joint_error_mean = error_sum / steps;
+    result.end = robot.bodies[0].get_position();
+    return result;
+}
+
+void print(const char* solver, Result const& r, Result const& reference, int robot_id, int scene)
+{
+    fprintf(stderr, "%5d %5d  %-9s %10.0f %7.2fx %9.3f %9.3f %9.3f %9.3f%s\n"
+           , robot_id, scene, solver
+           , r.steps_per_second, r.steps_per_second / reference.steps_per_second
+           , r.joint_error_mean * 1000, r.joint_error_max * 1000
+           , distance(r.start, r.end), distance(r.end, reference.end)
+           , r.diverged ? "  diverged" : "");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    dInitODE();
+
+    const double seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+    global_conf.quickstep_iterations = (argc > 2) ? atoi(argv[2]) : constants::quickstep_iterations;
+    global_conf.quickstep_SOR        = (argc > 3) ? atof(argv[3]) : constants::quickstep_SOR;
+    global_conf.disable_graphics     = true;
+
+    const unsigned int steps = seconds / global_conf.step_length;
+
+    /* all robots without random model parameters */
+    const int robots[] = { 10, 11, 20, 30, 31, 32, 33, 34, 60, 80, 90, 91, 92, 93, 94 };
+    const int num_scenes = 7;
+
+    fprintf(stderr, "%.1f s simulated per run, QuickStep with %d iterations and SOR %g\n"
+           , seconds, global_conf.quickstep_iterations, global_conf.quickstep_SOR);
+    fprintf(stderr, "robot scene  solver       steps/s  speedup  joint error [mm]   travelled     drift\n"
+                    "                                              mean       max         [m]       [m]\n");
+
+    for (int robot_id : robots)
+        for (int scene = 0; scene < num_scenes; ++scene) {
+            const Result exact = run(robot_id, scene, false, steps);
+            const Result quick = run(robot_id, scene, true , steps);
+            print("WorldStep", exact, exact, robot_id, scene);
+            print("QuickStep", quick, exact, robot_id, scene);
+        }
+    dCloseODE();
+    return 0;
+}
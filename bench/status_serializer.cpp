@@ -0,0 +1,131 @@
+/* Micro-benchmark: formatting of the text status message.
+ *
+ * Compares the former path (fresh std::string, one snprintf("%lf ") and append
+ * per value) with the StatusWriter (preallocated buffer, std::to_chars) for
+ * robots with 10, 20 and 32 joints, and checks that both produce the same bytes.
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=c++1z -Isrc bench/status_serializer.cpp \
+ *       src/communication/status_writer.cpp src/communication/transport.cpp -o bench_status
+ *   ./bench_status
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <communication/status_writer.h>
+
+namespace {
+
+std::size_t allocations = 0;
+
+/* counts the bytes, stands in for the socket */
+class NullTransport : public Transport {
+public:
+    bool establish_connection(void) { return true; }
+    bool send_message(const std::string& msg) { bytes += msg.size(); return true; }
+    bool send_parts(const struct iovec* parts, int count) {
+        for (int i = 0; i < count; ++i) bytes += parts[i].iov_len;
+        return true;
+    }
+    std::size_t bytes = 0;
+protected:
+    std::size_t receive(char*, std::size_t) { return 0; } // nothing to read, the client is gone
+};
+
+/* the former TCPController::send_ordered_info, text mode */
+std::string format_snprintf(std::vector<double> const& status)
+{
+    const std::size_t buffer_size = 4096;
+    char tmp[buffer_size];
+    std::string message;
+
+    for (double const& value : status) {
+        snprintf(tmp, buffer_size, "%lf ", value);
+        message.append(tmp);
+    }
+    return message;
+}
+
+/* status of a robot: time, pos, vel, current per joint, one accel. sensor, 6 values per body */
+std::vector<double> make_status(std::size_t num_joints, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> angle(-1.0, 1.0), speed(-20.0, 20.0);
+    std::vector<double> status;
+    status.push_back(12.34);
+    for (std::size_t i = 0; i < num_joints; ++i) status.push_back(angle(rng));
+    for (std::size_t i = 0; i < num_joints; ++i) status.push_back(speed(rng));
+    for (std::size_t i = 0; i < num_joints; ++i) status.push_back(angle(rng));
+    for (std::size_t i = 0; i < 3; ++i)          status.push_back(speed(rng));
+    for (std::size_t i = 0; i < 6 * (num_joints + 1); ++i) status.push_back(angle(rng));
+    return status;
+}
+
+template <typename Func>
+double measure_ns(unsigned int repetitions, Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repetitions; ++r)
+        func();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / repetitions;
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(void)
+{
+    const unsigned int repetitions = 20000;
+    std::mt19937 rng(42);
+
+    printf("joints  values   snprintf [ns]  allocs   to_chars [ns]  allocs   speedup\n");
+
+    for (std::size_t num_joints : {10, 20, 32})
+    {
+        const std::vector<double> status = make_status(num_joints, rng);
+        NullTransport connection;
+        StatusWriter writer;
+        writer.reserve(status.size());
+
+        /* both paths must produce the same message */
+        writer.start(false);
+        writer.append(status);
+        if (std::string(writer.data(), writer.size()) != format_snprintf(status)) {
+            printf("ERROR: messages differ for %lu joints.\n", num_joints);
+            return EXIT_FAILURE;
+        }
+
+        std::size_t allocs = allocations;
+        const double t_old = measure_ns(repetitions, [&]() { connection.send_message(format_snprintf(status)); });
+        const std::size_t allocs_old = allocations - allocs;
+
+        allocs = allocations;
+        const double t_new = measure_ns(repetitions, [&]() {
+            writer.start(false);
+            writer.append(status);
+            writer.send(connection);
+        });
+        const std::size_t allocs_new = allocations - allocs;
+
+        printf("%6lu  %6lu   %13.0f  %6.1f   %13.0f  %6.1f   %6.2fx\n",
+               num_joints, status.size(),
+               t_old, double(allocs_old) / repetitions,
+               t_new, double(allocs_new) / repetitions,
+               t_old / t_new);
+    }
+    return EXIT_SUCCESS;
+}
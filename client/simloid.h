@@ -0,0 +1,52 @@
+#ifndef SIMLOID_H_INCLUDED
+#define SIMLOID_H_INCLUDED
+
+/* C interface of the simloid client library, for bindings (ctypes, cffi,
+ * Julia's ccall). Functions returning int give 0 on success and -1 on
+ * error, simloid_error() then describes the error. Status pointers stay
+ * valid until the next call of simloid_receive() or simloid_step(). */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct simloid_client simloid_client;
+
+simloid_client* simloid_create(void);
+void            simloid_destroy(simloid_client* c);
+const char*     simloid_error(const simloid_client* c);
+
+int simloid_connect_tcp (simloid_client* c, const char* host, int port);
+int simloid_connect_unix(simloid_client* c, const char* path);
+int simloid_connect_shm (simloid_client* c, const char* name);
+
+/* traits */
+size_t       simloid_num_bodies  (const simloid_client* c);
+size_t       simloid_num_joints  (const simloid_client* c);
+size_t       simloid_num_accels  (const simloid_client* c);
+size_t       simloid_status_size (const simloid_client* c);
+unsigned int simloid_action_delay(const simloid_client* c);
+const char*  simloid_joint_name  (const simloid_client* c, size_t idx);
+const char*  simloid_body_name   (const simloid_client* c, size_t idx);
+
+/* commands of the next control message */
+int  simloid_set_voltages   (simloid_client* c, const double* values, size_t count);
+int  simloid_set_positions  (simloid_client* c, const double* values, size_t count);
+int  simloid_set_max_torques(simloid_client* c, const double* values, size_t count);
+int  simloid_set_forces     (simloid_client* c, const double* values, size_t count);
+void simloid_command        (simloid_client* c, const char* line);
+void simloid_use_binary     (simloid_client* c, int enable);
+int  simloid_use_compression(simloid_client* c, double resolution, unsigned int keyframe_interval);
+
+/* control cycle */
+int           simloid_send   (simloid_client* c);
+const double* simloid_receive(simloid_client* c, size_t* count);
+const double* simloid_step   (simloid_client* c, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMLOID_H_INCLUDED */
@@ -0,0 +1,603 @@
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include <communication/binary_protocol.h>
+#include <communication/shm_layout.h>
+
+#include "simloid_client.h"
+#include "simloid.h"
+
+namespace simloid {
+
+namespace {
+    const std::size_t initial_capacity = 1 << 16;
+    const std::size_t min_receive      = 1 << 12;
+
+    bool is_blank(const char c) { return ' ' == c or '\n' == c or '\r' == c or '\t' == c; }
+
+    /* shared memory mailboxes, see shm_layout.h */
+    const unsigned int spin_iterations = 4096;      // busy waiting before going to sleep
+    const long         wait_timeout_ns = 100000000; // 100ms, wake up to check for the server
+
+    void futex_wait(std::atomic<uint32_t>& word, uint32_t expected)
+    {
+        struct timespec timeout{0, wait_timeout_ns};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+    }
+
+    void futex_wake(std::atomic<uint32_t>& word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    /* wait until word differs from old value, returns false if the server is gone */
+    bool wait_for_change(shm_layout::Region const& region, std::atomic<uint32_t>& word, uint32_t old)
+    {
+        for (unsigned int i = 0; i < spin_iterations; ++i)
+            if (word.load(std::memory_order_acquire) != old)
+                return true;
+
+        while (word.load(std::memory_order_acquire) == old) {
+            if (region.connected.load(std::memory_order_acquire) == 0) return false;
+            futex_wait(word, old);
+        }
+        return true;
+    }
+
+    template <typename T>
+    void get_little_endian(T* dest, const char* src, std::size_t count)
+    {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        memcpy(dest, src, count * sizeof(T));
+#else
+        typedef typename std::conditional<sizeof(T) == 8, uint64_t,
+                typename std::conditional<sizeof(T) == 4, uint32_t, uint16_t>::type>::type Bits;
+        for (std::size_t i = 0; i < count; ++i) {
+            Bits v = 0;
+            for (unsigned b = 0; b < sizeof(T); ++b)
+                v |= Bits(static_cast<uint8_t>(src[i * sizeof(T) + b])) << (8 * b);
+            memcpy(&dest[i], &v, sizeof(T));
+        }
+#endif
+    }
+}
+
+bool Client::connect_tcp(std::string const& host, int port)
+{
+    close();
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* addr = nullptr;
+    if (0 != getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addr))
+        return fail("unknown host '" + host + "'");
+
+    fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    const bool connected = (fd >= 0) and (0 == ::connect(fd, addr->ai_addr, addr->ai_addrlen));
+    freeaddrinfo(addr);
+    if (not connected)
+        return fail("can not connect to " + host + ":" + std::to_string(port) + ": " + strerror(errno));
+
+    int flag = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    return handshake();
+}
+
+bool Client::connect_unix(std::string const& path)
+{
+    close();
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        return fail("socket path too long: '" + path + "'");
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 or 0 != ::connect(fd, (struct sockaddr*) &addr, sizeof(addr)))
+        return fail("can not connect to '" + path + "': " + strerror(errno));
+
+    return handshake();
+}
+
+bool Client::connect_shm(std::string const& name)
+{
+    close();
+
+    const std::string path = (name.empty() or name[0] != '/') ? "/" + name : name;
+    const int shm_fd = shm_open(path.c_str(), O_RDWR, 0);
+    if (shm_fd < 0)
+        return fail("can not open shared memory '" + path + "': " + strerror(errno));
+
+    /* the server sizes the object before it writes the magic */
+    struct stat st;
+    void* addr = MAP_FAILED;
+    if (0 == fstat(shm_fd, &st) and std::size_t(st.st_size) >= sizeof(shm_layout::Region))
+        addr = mmap(nullptr, sizeof(shm_layout::Region), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    ::close(shm_fd);
+    if (MAP_FAILED == addr)
+        return fail("can not map shared memory '" + path + "'");
+
+    region = static_cast<shm_layout::Region*>(addr);
+    const bool valid = (shm_layout::magic == region->magic);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (not valid or shm_layout::version != region->version or region->connected.load(std::memory_order_acquire) != 0) {
+        munmap(region, sizeof(shm_layout::Region));
+        region = nullptr;
+        return fail("shared memory '" + path + "' is not waiting for a client");
+    }
+
+    region->client_pid.store(getpid(), std::memory_order_relaxed);
+    region->connected.store(1, std::memory_order_release);
+    futex_wake(region->connected);
+    return handshake();
+}
+
+void Client::close(void)
+{
+    if (connected()) {
+        const char exit_command[] = "EXIT\n";
+        write_all(exit_command, sizeof(exit_command) - 1);
+    }
+    if (fd >= 0)
+        ::close(fd);
+    if (region) {
+        region->connected.store(0, std::memory_order_release);
+        futex_wake(region->command.seq);
+        futex_wake(region->status.ack);
+        munmap(region, sizeof(shm_layout::Region));
+    }
+    fd = -1;
+    region = nullptr;
+    chunk_offset = 0;
+    info = Traits();
+    head = tail = 0;
+    out.clear();
+    values.clear();
+    binary = binary_requested = previous_binary = false;
+    statuses_in_previous_mode = 0;
+    outstanding = 0;
+    resolution = resolution_requested = previous_resolution = frame_resolution = 0.0;
+}
+
+/* read the traits and confirm them, the first status follows */
+bool Client::handshake(void)
+{
+    in.resize(initial_capacity);
+
+    std::string_view line;
+    if (not read_line(line))
+        return false;
+    if (3 != sscanf(line.data(), "%zu %zu %zu", &info.num_bodies, &info.num_joints, &info.num_accels))
+        return fail("bad traits message");
+
+    char name[256];
+    for (std::size_t i = 0; i < info.num_joints; ++i) {
+        double lo, hi, def;
+        unsigned int type, sym;
+        std::size_t idx;
+        if (not read_line(line))
+            return false;
+        if (7 != sscanf(line.data(), "%zu %u %u %le %le %le %255s", &idx, &type, &sym, &lo, &hi, &def, name))
+            return fail("bad joint in traits message");
+        info.joint_names.push_back(name);
+        info.joint_default.push_back(def);
+    }
+    for (std::size_t i = 0; i < info.num_bodies; ++i) {
+        std::size_t idx;
+        if (not read_line(line))
+            return false;
+        if (2 != sscanf(line.data(), "%zu %255s", &idx, name))
+            return fail("bad body in traits message");
+        info.body_names.push_back(name);
+    }
+
+    out = "ACK\n";
+    if (not write_all(out.data(), out.size()))
+        return fail(std::string("can not send: ") + strerror(errno));
+    out.clear();
+
+    /* pipelined mode appends the action delay, the status starts with a number */
+    while (head == tail)
+        if (not fill()) return false;
+    if ('a' == in[head]) {
+        if (not read_line(line))
+            return false;
+        sscanf(line.data(), "action_delay %u", &info.action_delay);
+    }
+
+    /* the first status, in pipelined mode the server sends further ones ahead */
+    outstanding = 1 + info.action_delay;
+    values.reserve(info.status_size());
+    return true;
+}
+
+/* receive more bytes behind tail, keeping [head, tail) */
+/* all of data to the socket or in chunks to the command mailbox, errno tells the failure */
+bool Client::write_all(const char* data, std::size_t size)
+{
+    if (fd >= 0) {
+        while (size > 0) {
+            const ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (n < 0 and EINTR == errno) continue;
+            if (n < 0) return false;
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    auto& box = region->command;
+    do {
+        /* wait until the server consumed the last chunk */
+        const uint32_t seq = box.seq.load(std::memory_order_relaxed);
+        uint32_t ack;
+        while ((ack = box.ack.load(std::memory_order_acquire)) != seq)
+            if (not wait_for_change(*region, box.ack, ack)) {
+                errno = EPIPE;
+                return false;
+            }
+
+        const std::size_t length = std::min<std::size_t>(size, shm_layout::capacity);
+        memcpy(box.data, data, length);
+        box.length = length;
+        box.seq.store(seq + 1, std::memory_order_release);
+        futex_wake(box.seq);
+
+        data += length;
+        size -= length;
+    } while (size > 0);
+    return true;
+}
+
+/* like recv: number of bytes, 0 if the server closed the connection or < 0 on error */
+ssize_t Client::read_some(char* dest, std::size_t max, int flags)
+{
+    if (fd >= 0) {
+        ssize_t n;
+        while ((n = recv(fd, dest, max, flags)) < 0 and EINTR == errno) {}
+        return n;
+    }
+
+    auto& box = region->status;
+    std::size_t n = 0;
+    while (0 == n)
+    {
+        if (0 == chunk_offset) {
+            const uint32_t ack = box.ack.load(std::memory_order_relaxed);
+            if (not wait_for_change(*region, box.seq, ack))
+                return 0;
+        }
+
+        /* a chunk may be larger than the buffer, it is acknowledged when fully read */
+        n = std::min<std::size_t>(box.length - chunk_offset, max);
+        memcpy(dest, box.data + chunk_offset, n);
+        chunk_offset += n;
+
+        if (chunk_offset >= box.length) {
+            chunk_offset = 0;
+            box.ack.store(box.seq.load(std::memory_order_acquire), std::memory_order_release);
+            futex_wake(box.ack);
+        }
+    }
+    return n;
+}
+
+bool Client::fill(void)
+{
+    if (head == tail)
+        head = tail = 0;
+
+    if (in.size() - tail < min_receive) {
+        memmove(in.data(), in.data() + head, tail - head);
+        tail -= head;
+        head  = 0;
+        if (in.size() - tail < min_receive)
+            in.resize(2 * in.size());
+    }
+
+    const ssize_t n = read_some(&in[tail], in.size() - tail);
+    if (n <= 0)
+        return fail(n < 0 ? std::string("can not receive: ") + strerror(errno) : std::string("server closed the connection"));
+
+    tail += n;
+    return true;
+}
+
+bool Client::read_line(std::string_view& line)
+{
+    char* end;
+    while (nullptr == (end = static_cast<char*>(memchr(in.data() + head, '\n', tail - head))))
+        if (not fill()) return false;
+
+    *end = '\0';
+    line = std::string_view(&in[head], end - &in[head]);
+    head = end - in.data() + 1;
+    return true;
+}
+
+/* copy what is buffered, receive the rest directly into dest */
+bool Client::read_bytes(void* dest, std::size_t num)
+{
+    const std::size_t buffered = std::min(num, tail - head);
+    memcpy(dest, in.data() + head, buffered);
+    head += buffered;
+
+    char* rest = static_cast<char*>(dest) + buffered;
+    num -= buffered;
+    while (num > 0) {
+        const ssize_t n = read_some(rest, num, MSG_WAITALL);
+        if (n <= 0)
+            return fail(n < 0 ? std::string("can not receive: ") + strerror(errno) : std::string("server closed the connection"));
+        rest += n;
+        num  -= n;
+    }
+    return true;
+}
+
+bool Client::append_values(uint8_t opcode, const char* name, const double* v, std::size_t count, std::size_t expected)
+{
+    if (count != expected)
+        return fail(std::string(name) + ": expected " + std::to_string(expected) + " values, got " + std::to_string(count));
+
+    if (binary_requested) { // encoding after a switch in this message
+        out.push_back(static_cast<char>(opcode));
+        binary_protocol::put_u32(out, count);
+        for (std::size_t i = 0; i < count; ++i)
+            binary_protocol::put_f64(out, v[i]);
+        return true;
+    }
+
+    char tmp[32];
+    out.append(name);
+    for (std::size_t i = 0; i < count; ++i) {
+        tmp[0] = ' ';
+        const auto res = std::to_chars(tmp + 1, tmp + sizeof(tmp), v[i]);
+        out.append(tmp, res.ptr - tmp);
+    }
+    out.push_back('\n');
+    return true;
+}
+
+bool Client::set_voltages   (const double* v, std::size_t n) { return append_values(binary_protocol::UX, "UX", v, n, info.num_joints); }
+bool Client::set_positions  (const double* v, std::size_t n) { return append_values(binary_protocol::PX, "PX", v, n, info.num_joints); }
+bool Client::set_max_torques(const double* v, std::size_t n) { return append_values(binary_protocol::TX, "TX", v, n, info.num_joints); }
+bool Client::set_forces     (const double* v, std::size_t n) { return append_values(binary_protocol::FX, "FX", v, n, 3 * info.num_bodies); }
+
+void Client::command(std::string_view line)
+{
+    out.append(line);
+    if (line.empty() or line.back() != '\n')
+        out.push_back('\n');
+}
+
+void Client::use_binary(bool enable)
+{
+    command(enable ? "BINARY MODE" : "TEXT MODE");
+    binary_requested = enable;
+}
+
+/* the shortest round-trip form, so the server quantizes with exactly this resolution */
+bool Client::use_compression(double res, unsigned int keyframe_interval)
+{
+    if (not std::isfinite(res) or res < 0.0)
+        return fail("invalid resolution");
+
+    if (res > 0.0) {
+        char tmp[32];
+        const auto r = std::to_chars(tmp, tmp + sizeof(tmp), res);
+        command("COMPRESSION " + std::string(tmp, r.ptr) + " " + std::to_string(keyframe_interval));
+    }
+    else
+        command("COMPRESSION OFF");
+    resolution_requested = res;
+    return true;
+}
+
+bool Client::send(void)
+{
+    if (not connected())
+        return fail("not connected");
+
+    out.append("DONE\n");
+    const bool sent = write_all(out.data(), out.size());
+    out.clear();
+    if (not sent)
+        return fail(std::string("can not send: ") + strerror(errno));
+
+    /* statuses not yet received arrive in the former protocol */
+    if (binary_requested != binary or resolution_requested != resolution) {
+        previous_binary = binary;
+        previous_resolution = resolution;
+        binary = binary_requested;
+        resolution = resolution_requested;
+        statuses_in_previous_mode = outstanding;
+    }
+    ++outstanding;
+    return true;
+}
+
+bool Client::receive(void)
+{
+    if (not connected())
+        return fail("not connected");
+
+    if (outstanding > 0) --outstanding;
+
+    bool frame = binary;
+    frame_resolution = resolution;
+    if (statuses_in_previous_mode > 0) {
+        frame = previous_binary;
+        frame_resolution = previous_resolution;
+        --statuses_in_previous_mode;
+    }
+    return frame ? receive_frame() : receive_text();
+}
+
+/* text status: the values are each followed by a blank */
+bool Client::receive_text(void)
+{
+    values.resize(info.status_size());
+    for (double& v : values)
+    {
+        for (;;) {
+            while (head < tail and is_blank(in[head])) ++head;
+            if (head < tail) {
+                const char* end = static_cast<const char*>(memchr(in.data() + head, ' ', tail - head));
+                if (end) {
+                    const auto res = std::from_chars(&in[head], end, v);
+                    if (res.ec != std::errc() or res.ptr != end)
+                        return fail("bad value in status message");
+                    head = end - in.data() + 1;
+                    break;
+                }
+            }
+            if (not fill()) return false;
+        }
+    }
+    return true;
+}
+
+bool Client::receive_frame(void)
+{
+    /* usually receives the whole frame, larger payloads are read directly */
+    while (tail - head < binary_protocol::frame_header_size)
+        if (not fill()) return false;
+
+    char header[binary_protocol::frame_header_size];
+    read_bytes(header, sizeof(header));
+
+    const uint32_t length = binary_protocol::get_u32(header);
+    const uint32_t type   = binary_protocol::get_u32(header + 4);
+
+    switch (type)
+    {
+        case binary_protocol::status:
+            values.resize(length / sizeof(double));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            return read_bytes(values.data(), length);
+#else
+            payload.resize(length);
+            if (not read_bytes(payload.data(), length)) return false;
+            get_little_endian(values.data(), payload.data(), values.size());
+            return true;
+#endif
+        case binary_protocol::keyframe:
+        {
+            if (frame_resolution <= 0.0)
+                return fail("compressed status, but no resolution");
+            payload.resize(length);
+            if (not read_bytes(payload.data(), length)) return false;
+            quantized.resize(length / sizeof(int32_t));
+            get_little_endian(quantized.data(), payload.data(), quantized.size());
+            break;
+        }
+        case binary_protocol::delta:
+        {
+            if (length / sizeof(int16_t) != quantized.size())
+                return fail("delta without matching keyframe");
+            payload.resize(length);
+            if (not read_bytes(payload.data(), length)) return false;
+            deltas.resize(quantized.size());
+            get_little_endian(deltas.data(), payload.data(), deltas.size());
+            for (std::size_t i = 0; i < quantized.size(); ++i)
+                quantized[i] += deltas[i];
+            break;
+        }
+        default:
+            payload.resize(length);
+            read_bytes(payload.data(), length);
+            return fail("unexpected frame type " + std::to_string(type));
+    }
+
+    values.resize(quantized.size());
+    for (std::size_t i = 0; i < quantized.size(); ++i)
+        values[i] = quantized[i] * frame_resolution;
+    return true;
+}
+
+bool Client::fail(std::string const& what)
+{
+    error_msg = what;
+    return false;
+}
+
+} // namespace simloid
+
+
+/* C interface */
+struct simloid_client {
+    simloid::Client client;
+};
+
+extern "C" {
+
+simloid_client* simloid_create(void) { return new simloid_client; }
+void            simloid_destroy(simloid_client* c) { delete c; }
+const char*     simloid_error(const simloid_client* c) { return c->client.error().c_str(); }
+
+int simloid_connect_tcp (simloid_client* c, const char* host, int port) { return c->client.connect_tcp(host, port) ? 0 : -1; }
+int simloid_connect_unix(simloid_client* c, const char* path)           { return c->client.connect_unix(path)      ? 0 : -1; }
+int simloid_connect_shm (simloid_client* c, const char* name)           { return c->client.connect_shm(name)       ? 0 : -1; }
+
+size_t       simloid_num_bodies  (const simloid_client* c) { return c->client.traits().num_bodies; }
+size_t       simloid_num_joints  (const simloid_client* c) { return c->client.traits().num_joints; }
+size_t       simloid_num_accels  (const simloid_client* c) { return c->client.traits().num_accels; }
+size_t       simloid_status_size (const simloid_client* c) { return c->client.traits().status_size(); }
+unsigned int simloid_action_delay(const simloid_client* c) { return c->client.traits().action_delay; }
+
+const char* simloid_joint_name(const simloid_client* c, size_t idx) {
+    auto const& names = c->client.traits().joint_names;
+    return idx < names.size() ? names[idx].c_str() : nullptr;
+}
+const char* simloid_body_name(const simloid_client* c, size_t idx) {
+    auto const& names = c->client.traits().body_names;
+    return idx < names.size() ? names[idx].c_str() : nullptr;
+}
+
+int  simloid_set_voltages   (simloid_client* c, const double* v, size_t n) { return c->client.set_voltages   (v, n) ? 0 : -1; }
+int  simloid_set_positions  (simloid_client* c, const double* v, size_t n) { return c->client.set_positions  (v, n) ? 0 : -1; }
+int  simloid_set_max_torques(simloid_client* c, const double* v, size_t n) { return c->client.set_max_torques(v, n) ? 0 : -1; }
+int  simloid_set_forces     (simloid_client* c, const double* v, size_t n) { return c->client.set_forces     (v, n) ? 0 : -1; }
+void simloid_command        (simloid_client* c, const char* line) { c->client.command(line); }
+void simloid_use_binary     (simloid_client* c, int enable) { c->client.use_binary(enable != 0); }
+int  simloid_use_compression(simloid_client* c, double resolution, unsigned int keyframe_interval) { return c->client.use_compression(resolution, keyframe_interval) ? 0 : -1; }
+
+int simloid_send(simloid_client* c) { return c->client.send() ? 0 : -1; }
+
+const double* simloid_receive(simloid_client* c, size_t* count)
+{
+    if (not c->client.receive()) return nullptr;
+    if (count) *count = c->client.status_count();
+    return c->client.status();
+}
+
+const double* simloid_step(simloid_client* c, size_t* count)
+{
+    if (not c->client.send()) return nullptr;
+    return simloid_receive(c, count);
+}
+
+} // extern "C"
@@ -0,0 +1,113 @@
+#ifndef SIMLOID_CLIENT_H_INCLUDED
+#define SIMLOID_CLIENT_H_INCLUDED
+
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace shm_layout { struct Region; }
+
+namespace simloid {
+
+/* robot description of the traits message */
+struct Traits {
+    std::size_t num_bodies = 0;
+    std::size_t num_joints = 0;
+    std::size_t num_accels = 0;
+    std::vector<std::string> joint_names;
+    std::vector<double>      joint_default; // default positions, normalized to [-1, 1]
+    std::vector<std::string> body_names;
+    unsigned int action_delay = 0;         // control steps until a reply takes effect, pipelined mode
+
+    std::size_t status_size(void) const { return 1 + 3 * num_joints + 3 * num_accels + 6 * num_bodies; }
+};
+
+/* Client of the simloid server (see doc/readme.txt).
+ * Messages are framed by the protocol, not by the sizes of the reads: text
+ * status messages by their number of values, binary ones by their header.
+ * Commands are collected and sent as one control message by send(). The
+ * status is decoded into a buffer of the client and handed out as a view,
+ * valid until the next receive().
+ *
+ * Text framing assumes the full status message of one robot, so SUBSCRIBE
+ * and BATCH need the binary protocol. MODEL and ROLLOUT are not supported. */
+class Client {
+public:
+    Client() = default;
+    ~Client() { close(); }
+
+    bool connect_tcp(std::string const& host, int port);
+    bool connect_unix(std::string const& path);
+    bool connect_shm (std::string const& name); // server started with '--shm <name>'
+    void close(void);
+
+    Traits const& traits(void) const { return info; }
+
+    /* commands of the next control message */
+    bool set_voltages   (const double* values, std::size_t count); // UX, count = number of joints
+    bool set_positions  (const double* values, std::size_t count); // PX
+    bool set_max_torques(const double* values, std::size_t count); // TX
+    bool set_forces     (const double* values, std::size_t count); // FX, count = 3 * number of bodies
+    void command(std::string_view line);                           // any other text command, e.g. "RESET"
+    void use_binary(bool enable);                                  // switch protocol with the next message
+    bool use_compression(double resolution, unsigned int keyframe_interval = 100); // binary only, 0 = off
+
+    bool send(void);    // terminate the message with 'DONE' and send it
+    bool receive(void); // next status message
+    bool step(void) { return send() and receive(); }
+
+    const double* status(void) const { return values.data(); }
+    std::size_t   status_count(void) const { return values.size(); }
+
+    std::string const& error(void) const { return error_msg; }
+
+private:
+    bool handshake(void);
+    bool connected(void) const { return fd >= 0 or region != nullptr; }
+    bool write_all(const char* data, std::size_t size);
+    ssize_t read_some(char* dest, std::size_t max, int flags = 0);
+    bool fill(void);
+    bool read_line(std::string_view& line);
+    bool read_bytes(void* dest, std::size_t num);
+    bool receive_text(void);
+    bool receive_frame(void);
+    bool append_values(uint8_t opcode, const char* name, const double* values, std::size_t count, std::size_t expected);
+    bool fail(std::string const& what);
+
+    int    fd = -1;
+    shm_layout::Region* region = nullptr; // instead of fd, shared memory transport
+    std::size_t chunk_offset = 0;          // bytes of the current status chunk already read
+    Traits info;
+
+    std::vector<char> in;       // received bytes [head, tail)
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    std::string out;            // control message under construction
+
+    std::vector<double>  values;    // decoded status
+    std::vector<int32_t> quantized; // last compressed status
+    std::vector<int16_t> deltas;
+    std::vector<char>    payload;   // compressed frames
+
+    bool         binary = false;
+    bool         binary_requested = false;
+    bool         previous_binary = false;
+    unsigned int outstanding = 0;               // statuses sent by the server, not yet received
+    unsigned int statuses_in_previous_mode = 0; // outstanding at the protocol switch
+    double       resolution = 0.0;           // of the compressed statuses
+    double       resolution_requested = 0.0; // takes effect with the next message
+    double       previous_resolution = 0.0;
+    double       frame_resolution = 0.0;     // of the status being received
+
+    std::string error_msg;
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+};
+
+} // namespace simloid
+
+#endif // SIMLOID_CLIENT_H_INCLUDED
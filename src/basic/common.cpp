@@ -19,12 +19,13 @@ void common::normalizeVector3 (double v[3])
 
 /* normal random variate generator
  * mean m, standard deviation s
+ * the second variate is kept per thread, sessions are stepped by several threads
  */
 double common::box_muller(const double m, const double s, const double min, const double max)
 {
     double x1, x2, w, y1;
-    static double y2;
-    static int use_last = 0;
+    static thread_local double y2;
+    static thread_local int use_last = 0;
 
     if (use_last) /* use value from previous call */
     {
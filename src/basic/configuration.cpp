@@ -8,14 +8,28 @@
 
 Configuration::Configuration()
 : tcp_port         (8000)
+, shm_name         ("")
+, socket_path      ("")
+, session_threads  (0)
+, persistent_server(false)
+, record_file      ("")
+, replay_file      ("")
+, observer_port    (0)
+, observer_address ("127.0.0.1")
+, observer_interval(1)
 , robot            (31)
 , scene            (0)
 , initial_gravity  (true)
 , step_length      (constants::default_step_length)
 , real_time        (true)
 , initial_pause    (false)
+, deadline_mode    (false)
 , contact_soft_ERP (constants::contact_soft_ERP)
 , contact_soft_CFM (constants::contact_soft_CFM)
+, quick_step       (false)
+, quickstep_iterations(constants::quickstep_iterations)
+, quickstep_SOR    (constants::quickstep_SOR)
+, collision_space  ("hash")
 , disable_graphics (false)
 , draw_scene       (true)
 , show_aabb        (false)
@@ -33,6 +47,8 @@ Configuration::Configuration()
 , pidP             (3.5)
 , pidI             (0.0)
 , pidD             (0.1)
+, steps_per_control(1)
+, pipelined_mode   (false)
 {
     // create list for external access to configuration parameter
     init_parameter_vector();
@@ -47,6 +63,15 @@ void Configuration::init_parameter_vector(void)
     theParameterVector.clear();
     /* General */
     theParameterVector.push_back(parameter("General"      , "tcp_port"          , &tcp_port          , INT   , "TCP port where to connect client"          ));
+    theParameterVector.push_back(parameter("General"      , "shm_name"          , &shm_name          , STRING, "shared memory name, used instead of TCP"   ));
+    theParameterVector.push_back(parameter("General"      , "socket_path"       , &socket_path       , STRING, "unix domain socket path, used instead of TCP"));
+    theParameterVector.push_back(parameter("General"      , "session_threads"   , &session_threads   , INT   , "threads for multiple sessions (0 = single)" ));
+    theParameterVector.push_back(parameter("General"      , "persistent_server" , &persistent_server , BOOL  , "accept the next client after a disconnect" ));
+    theParameterVector.push_back(parameter("General"      , "record_file"       , &record_file       , STRING, "record the client's commands to this file" ));
+    theParameterVector.push_back(parameter("General"      , "replay_file"       , &replay_file       , STRING, "replay a recorded session, no client"      ));
+    theParameterVector.push_back(parameter("General"      , "observer_port"     , &observer_port     , INT   , "UDP port of status broadcast (0 = off)"    ));
+    theParameterVector.push_back(parameter("General"      , "observer_address"  , &observer_address  , STRING, "local or multicast address of observers"   ));
+    theParameterVector.push_back(parameter("General"      , "observer_interval" , &observer_interval , INT   , "broadcast every k-th status message"       ));
     /* Environment   */
     theParameterVector.push_back(parameter("Environment"  , "robot"             , &robot             , INT   , "index number of robot's bodyplan"          ));
     theParameterVector.push_back(parameter("Environment"  , "scene"             , &scene             , INT   , "index number of experimental setup"        ));
@@ -55,8 +80,13 @@ void Configuration::init_parameter_vector(void)
     theParameterVector.push_back(parameter("Simulation"   , "step_length"       , &step_length       , DOUBLE, "step length for one simulation step in s"  ));
     theParameterVector.push_back(parameter("Simulation"   , "real_time"         , &real_time         , BOOL  , "slow down simulation velocity to 1.0x"     ));
     theParameterVector.push_back(parameter("Simulation"   , "initial_pause"     , &initial_pause     , BOOL  , "start simulation in pause-mode"            ));
+    theParameterVector.push_back(parameter("Simulation"   , "deadline_mode"     , &deadline_mode     , BOOL  , "keep stepping when the client is late"     ));
     theParameterVector.push_back(parameter("Simulation"   , "contact_soft_ERP"  , &contact_soft_ERP  , DOUBLE, "error reduction parameter during contacts" ));
     theParameterVector.push_back(parameter("Simulation"   , "contact_soft_CFM"  , &contact_soft_CFM  , DOUBLE, "constraint force mixing during contacts"   ));
+    theParameterVector.push_back(parameter("Simulation"   , "quick_step"        , &quick_step        , BOOL  , "iterative solver, faster for many contacts"));
+    theParameterVector.push_back(parameter("Simulation"   , "quickstep_iterations", &quickstep_iterations, INT   , "iterations of the quick step solver"       ));
+    theParameterVector.push_back(parameter("Simulation"   , "quickstep_SOR"     , &quickstep_SOR     , DOUBLE, "over-relaxation of the quick step solver"  ));
+    theParameterVector.push_back(parameter("Simulation"   , "collision_space"   , &collision_space   , STRING, "collision space: hash, sap or quadtree"    ));
     /* Visualization */
     theParameterVector.push_back(parameter("Visualization", "show_aabb"         , &show_aabb         , BOOL  , "show geom AABBs"                           ));
     theParameterVector.push_back(parameter("Visualization", "show_contacts"     , &show_contacts     , BOOL  , "show contact points"                       ));
@@ -75,6 +105,8 @@ void Configuration::init_parameter_vector(void)
     theParameterVector.push_back(parameter("Controller"   , "pidP"              , &pidP              , DOUBLE, "P-Value for PID-Controller"                ));
     theParameterVector.push_back(parameter("Controller"   , "pidI"              , &pidI              , DOUBLE, "I-Value for PID-Controller"                ));
     theParameterVector.push_back(parameter("Controller"   , "pidD"              , &pidD              , DOUBLE, "D-Value for PID-Controller"                ));
+    theParameterVector.push_back(parameter("Controller"   , "steps_per_control" , &steps_per_control , INT   , "physics steps per control message"         ));
+    theParameterVector.push_back(parameter("Controller"   , "pipelined_mode"    , &pipelined_mode    , BOOL  , "apply controls with one step delay"        ));
     return;
 }
 
@@ -113,17 +145,16 @@ bool Configuration::readConfigurationFile(const char* filename)
 	switch(pos->type) {
 		case STRING:
 			{
-				char lineCopy[strlen(line)];
-				strncpy(lineCopy, line, strlen(line));
-				strtok(lineCopy,"\"");
-				char* tmp = strtok(NULL,"\"");
-				if(tmp != NULL) {
-					parameterStringValue = std::string(tmp);
+				/* value between the first pair of quotes, may be empty */
+				const char* first = strchr(line, '"');
+				const char* last  = (first != NULL) ? strchr(first + 1, '"') : NULL;
+				if(last != NULL) {
+					parameterStringValue = std::string(first + 1, last);
 					std::string* target = static_cast<std::string*>(pos->variable);
 					*target = parameterStringValue;
 				}
 				else {
-					printf("WARNING: Illegal line: (%s) in config file (line #%d)\n", lineCopy, fh.getLineNumber());
+					printf("WARNING: Illegal line: (%s) in config file (line #%d)\n", line, fh.getLineNumber());
 					continue ;
 				}
 			}
@@ -21,6 +21,15 @@ public:
 
     /* General */
     int    tcp_port;            // TCP Port für TCPController //TODO make to Uint
+    std::string shm_name;       // name of shared memory object, replaces TCP if set
+    std::string socket_path;    // path of unix domain socket, replaces TCP if set
+    int    session_threads;     // worker threads of the multi-session server, 0 = single session
+    bool   persistent_server;   // wait for the next client instead of exiting
+    std::string record_file;    // write the client's command stream to this file, if set
+    std::string replay_file;    // replay a recorded session instead of serving a client, if set
+    int    observer_port;       // UDP port of the status broadcast to observers, 0 = off
+    std::string observer_address; // local or multicast address of the observers
+    int    observer_interval;   // broadcast every k-th status
 
     /* Environment */
     int    robot;               // number of the robot's body plan //TODO make to string
@@ -31,8 +40,13 @@ public:
     double step_length;         // Schrittweite, mit der ein Simulationsschritt ausgefuehrt wird
     bool   real_time;           // Simulationsgeschwindigkeit auf 1.0x bremsen
     bool   initial_pause;       // Soll im Pause-Modus gestartet werden?
+    bool   deadline_mode;       // step on at a fixed rate when the client's reply is late
     double contact_soft_ERP;    // error reduction parameter during contacts
     double contact_soft_CFM;    // constraint force mixing during contacts
+    bool   quick_step;          // iterative dWorldQuickStep instead of the exact dWorldStep
+    int    quickstep_iterations; // iterations of dWorldQuickStep
+    double quickstep_SOR;       // over-relaxation of dWorldQuickStep
+    std::string collision_space; // hash, sap or quadtree
 
     /* Visualization */
     bool   disable_graphics;    // creating window? (otherwise just running on console)
@@ -54,6 +68,8 @@ public:
     double pidP;                // P-Value for PID-Controller
     double pidI;                // I-Value for PID-Controller
     double pidD;                // D-Value for PID-Controller
+    int    steps_per_control;   // physics steps per received control message
+    bool   pipelined_mode;      // step on while the client computes, one step action delay
 
 
 private:
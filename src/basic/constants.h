@@ -22,6 +22,12 @@ namespace constants {
     const double world_CFM = 1e-5;
     const double world_ERP = 0.20;
 
+    const int    quickstep_iterations = 20;  // ODE's defaults
+    const double quickstep_SOR        = 1.3;
+
+    const int    quadtree_depth  = 6;
+    const double quadtree_margin = 2.0;      // space around the scene's bounds in m
+
     namespace friction
     {
         const double lo     =   1.0;
@@ -67,6 +73,9 @@ namespace constants {
     const unsigned int max_joints = 32; // max. number of joints
     const unsigned int max_accels = 32; // max. number of acceleration sensors
 
+    const unsigned int max_batch_size    = 256;  // max. number of instances of a batch
+    const unsigned int max_rollout_steps = 4096; // max. number of voltage vectors of a rollout
+
     const unsigned int max_obstacles = 1000;
     const unsigned int max_heightfields = 8;
 
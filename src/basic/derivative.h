@@ -82,9 +82,11 @@ struct Derived {
     double last = .0;
     double velocity = .0;
     const double inv_dt;
+    const double scale;
 
     Derived(double initial, double timestep, double scale)
     : inv_dt(scale/timestep)
+    , scale(scale)
     {
         reset(initial);
     }
@@ -96,6 +98,12 @@ struct Derived {
         last = current;
     }
 
+    /* for samples taken at varying intervals */
+    void derive(double current, double timestep) {
+        velocity = (current - last) * scale / timestep;
+        last = current;
+    }
+
     double get(void) const { return velocity; }
 };
 
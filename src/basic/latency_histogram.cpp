@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cmath>
+
+#include <draw/drawstuff.h>
+#include <basic/latency_histogram.h>
+
+void LatencyHistogram::record(uint64_t ns)
+{
+    buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t prev = maximum.load(std::memory_order_relaxed);
+    while (ns > prev and not maximum.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::clear(void)
+{
+    for (auto& b : buckets)
+        b.store(0, std::memory_order_relaxed);
+    total  .store(0, std::memory_order_relaxed);
+    sum    .store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean(void) const
+{
+    const uint64_t n = count();
+    return n ? double(sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const
+{
+    const uint64_t n = count();
+    if (0 == n) return 0;
+
+    const uint64_t rank = std::max<uint64_t>(1, std::ceil(std::min(p, 100.0) / 100.0 * n));
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < num_buckets; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(bucket_upper(i), max());
+    }
+    return max(); // counts changed while reading
+}
+
+void LatencyHistogram::print(const char* name) const
+{
+    dsPrint("%-8s n=%-9lu mean=%10.1f  p50=%10.1f  p90=%10.1f  p99=%10.1f  p99.9=%10.1f  max=%10.1f us\n"
+           , name, count(), mean() * 1e-3
+           , percentile(50.0) * 1e-3, percentile(90.0) * 1e-3, percentile(99.0) * 1e-3
+           , percentile(99.9) * 1e-3, max() * 1e-3);
+}
+
+/* [0, 2^sub_bits) one bucket per value, then 2^sub_bits buckets per power of two */
+std::size_t LatencyHistogram::bucket_index(uint64_t ns)
+{
+    const uint64_t sub_count = uint64_t(1) << sub_bits;
+    if (ns < sub_count) return ns;
+
+    ns = std::min(ns, (uint64_t(1) << max_bits) - 1);
+    const unsigned int msb   = 63 - __builtin_clzll(ns);
+    const unsigned int shift = msb - sub_bits;
+    return ((msb - sub_bits + 1) << sub_bits) + ((ns >> shift) - sub_count);
+}
+
+uint64_t LatencyHistogram::bucket_upper(std::size_t idx)
+{
+    const uint64_t sub_count = uint64_t(1) << sub_bits;
+    if (idx < sub_count) return idx;
+
+    const unsigned int shift = (idx >> sub_bits) - 1;
+    const uint64_t     lower = (sub_count + (idx & (sub_count - 1))) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
@@ -0,0 +1,47 @@
+#ifndef LATENCY_HISTOGRAM_H_INCLUDED
+#define LATENCY_HISTOGRAM_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/* Histogram of durations in nanoseconds with log-linear buckets, as in HDR
+ * histograms: values below 2^sub_bits are counted exactly, larger ones in
+ * 2^sub_bits buckets per power of two, i.e. with a resolution of about 3%.
+ * Recording is a few relaxed atomic operations without locks, so the
+ * histogram can be printed while it is being written. */
+class LatencyHistogram {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    LatencyHistogram() { clear(); }
+
+    void record(uint64_t ns);
+    void record(clock::time_point begin, clock::time_point end) {
+        record(end > begin ? std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() : 0);
+    }
+    void clear(void);
+
+    uint64_t count(void) const { return total.load(std::memory_order_relaxed); }
+    uint64_t max  (void) const { return maximum.load(std::memory_order_relaxed); }
+    double   mean (void) const;
+    uint64_t percentile(double p) const; // upper bound of the bucket holding the p-th percentile, p in [0, 100]
+
+    void print(const char* name) const; // one line, in microseconds
+
+    static const unsigned int sub_bits    = 5;
+    static const unsigned int max_bits    = 40; // larger values (> 18 min) are counted in the last bucket
+    static const std::size_t  num_buckets = std::size_t(max_bits - sub_bits + 1) << sub_bits;
+
+private:
+    static std::size_t bucket_index(uint64_t ns);
+    static uint64_t    bucket_upper(std::size_t idx);
+
+    std::atomic<uint64_t> buckets[num_buckets];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> maximum;
+};
+
+#endif // LATENCY_HISTOGRAM_H_INCLUDED
@@ -10,7 +10,11 @@ public:
     {
         new_action.sa_handler = fp;
         sigemptyset(&new_action.sa_mask);
-        new_action.sa_flags = 0;
+        new_action.sa_flags = 0; // SIGINT and SIGTERM interrupt blocking calls, e.g. waiting for a client
+
+        /* the statistics request must not disturb blocking calls */
+        usr1_action = new_action;
+        usr1_action.sa_flags = SA_RESTART;
 
         if (sigaction(SIGINT, &new_action, &old_action_int) == -1) {
             printf("Error sigaction --> errno = %d - %s\n", errno, strerror(errno));
@@ -20,7 +24,7 @@ public:
             printf("Error sigaction --> errno = %d - %s\n", errno, strerror(errno));
             exit(-1);
         }
-        if (sigaction(SIGUSR1, &new_action, &old_action_usr1) == -1) {
+        if (sigaction(SIGUSR1, &usr1_action, &old_action_usr1) == -1) {
             printf("Error sigaction --> errno = %d - %s\n", errno, strerror(errno));
             exit(-1);
         }
@@ -43,6 +47,7 @@ public:
     }
 private:
     struct sigaction new_action;
+    struct sigaction usr1_action;
     struct sigaction old_action_int;
     struct sigaction old_action_term;
     struct sigaction old_action_usr1;
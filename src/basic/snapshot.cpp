@@ -1,4 +1,5 @@
 #include <basic/snapshot.h>
+#include <communication/binary_protocol.h>
 
 
 template <typename ObjectList, typename StateList>
@@ -66,3 +67,112 @@ void playSnapshot(const Robot& robot, const Obstacle& obstacles, const Snapshot
     restore_objects(robot.attachments, s->attachments);
     restore_objects(obstacles.objects, s->obstacles  );
 }
+
+namespace {
+
+template <typename ObjectList>
+void put_bodies(std::string& blob, const ObjectList& objects)
+{
+    for (unsigned int i = 0; i < objects.size(); ++i)
+    {
+        const dBodyID b = objects[i].body;
+        for (unsigned int j = 0; j < 3; ++j) binary_protocol::put_f64(blob, dBodyGetPosition  (b)[j]);
+        for (unsigned int j = 0; j < 4; ++j) binary_protocol::put_f64(blob, dBodyGetQuaternion(b)[j]);
+        for (unsigned int j = 0; j < 3; ++j) binary_protocol::put_f64(blob, dBodyGetLinearVel (b)[j]);
+        for (unsigned int j = 0; j < 3; ++j) binary_protocol::put_f64(blob, dBodyGetAngularVel(b)[j]);
+    }
+}
+
+template <typename ObjectList>
+const char* get_bodies(const char* p, const ObjectList& objects)
+{
+    double v[simulator_state::body_size];
+    for (unsigned int i = 0; i < objects.size(); ++i)
+    {
+        for (unsigned int j = 0; j < simulator_state::body_size; ++j, p += 8)
+            v[j] = binary_protocol::get_f64(p);
+
+        const dBodyID b = objects[i].body;
+        dBodySetPosition  (b, v[0], v[1], v[2]);
+        dBodySetQuaternion(b, &v[3]);
+        dBodySetLinearVel (b, v[7], v[8], v[9]);
+        dBodySetAngularVel(b, v[10], v[11], v[12]);
+    }
+    return p;
+}
+
+} // namespace
+
+void serializeState(const Robot& robot, const Obstacle& obstacles, double time, std::string& blob)
+{
+    using namespace binary_protocol;
+
+    put_u32(blob, simulator_state::version);
+    put_u32(blob, robot.get_model_id().identifier);
+    put_u32(blob, robot.bodies.size());
+    put_u32(blob, robot.attachments.size());
+    put_u32(blob, obstacles.objects.size());
+    put_u32(blob, robot.number_of_joints());
+    put_u32(blob, robot.number_of_accels());
+    put_f64(blob, time);
+
+    put_bodies(blob, robot.bodies);
+    put_bodies(blob, robot.attachments);
+    put_bodies(blob, obstacles.objects);
+
+    double s[NJoint::state_size];
+    for (std::size_t i = 0; i < robot.number_of_joints(); ++i) {
+        robot.joints[i].get_state(s);
+        for (double v : s) put_f64(blob, v);
+    }
+
+    for (std::size_t i = 0; i < robot.number_of_accels(); ++i) {
+        Vector3 const& v = robot.accels[i].get_last_velocity();
+        put_f64(blob, v.x);
+        put_f64(blob, v.y);
+        put_f64(blob, v.z);
+    }
+}
+
+bool restoreState(Robot& robot, const Obstacle& obstacles, std::string_view blob, double& time)
+{
+    using namespace binary_protocol;
+
+    const std::size_t num_bodies = robot.bodies.size() + robot.attachments.size() + obstacles.objects.size();
+    const std::size_t size = simulator_state::header_size
+                           + 8 * ( simulator_state::body_size * num_bodies
+                                 + NJoint::state_size * robot.number_of_joints()
+                                 + 3 * robot.number_of_accels() );
+
+    const char* p = blob.data();
+    if (blob.size() != size
+        or get_u32(p     ) != simulator_state::version
+        or get_u32(p +  4) != robot.get_model_id().identifier
+        or get_u32(p +  8) != robot.bodies.size()
+        or get_u32(p + 12) != robot.attachments.size()
+        or get_u32(p + 16) != obstacles.objects.size()
+        or get_u32(p + 20) != robot.number_of_joints()
+        or get_u32(p + 24) != robot.number_of_accels())
+    {
+        dsPrint("ERROR: State of %lu bytes does not fit the robot and scene.\n", blob.size());
+        return false;
+    }
+    time = get_f64(p + 28);
+    p += simulator_state::header_size;
+
+    p = get_bodies(p, robot.bodies);
+    p = get_bodies(p, robot.attachments);
+    p = get_bodies(p, obstacles.objects);
+
+    double s[NJoint::state_size];
+    for (std::size_t i = 0; i < robot.number_of_joints(); ++i) {
+        for (double& v : s) { v = get_f64(p); p += 8; }
+        robot.joints[i].set_state(s);
+    }
+
+    for (std::size_t i = 0; i < robot.number_of_accels(); ++i, p += 24)
+        robot.accels[i].set_last_velocity(Vector3(get_f64(p), get_f64(p + 8), get_f64(p + 16)));
+
+    assert(p == blob.data() + blob.size());
+    return true;
+}
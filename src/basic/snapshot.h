@@ -1,6 +1,9 @@
 #ifndef SNAPSHOT_H_INCLUDED
 #define SNAPSHOT_H_INCLUDED
 
+#include <string>
+#include <string_view>
+
 #include <build/robot.h>
 #include <build/obstacles.h>
 
@@ -29,4 +32,21 @@ struct Snapshot {
 void recordSnapshot(const Robot& robot, const Obstacle& obstacles, Snapshot *s);
 void playSnapshot  (const Robot& robot, const Obstacle& obstacles, const Snapshot *s);
 
+/* Full simulator state as a portable blob (GETSTATE/SETSTATE): the snapshot's
+ * bodies plus the state of the joints' controllers and the accel sensors and
+ * the simulation time. Layout, little-endian:
+ *   uint32 version, uint32 robot, uint32 number of bodies, attachments,
+ *   obstacles, joints and accels, float64 time,
+ *   13 float64 per body, attachment and obstacle (position, quaternion,
+ *   linear and angular velocity), NJoint::state_size float64 per joint,
+ *   3 float64 per accel sensor (last velocity) */
+namespace simulator_state {
+    const uint32_t    version     = 1;
+    const std::size_t header_size = 7 * 4 + 8;
+    const std::size_t body_size   = 13;
+}
+
+void serializeState(const Robot& robot, const Obstacle& obstacles, double time, std::string& blob); // appends to blob
+bool restoreState  (Robot& robot, const Obstacle& obstacles, std::string_view blob, double& time); // false if blob does not fit the robot
+
 #endif // SNAPSHOT_H_INCLUDED
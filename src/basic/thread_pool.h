@@ -0,0 +1,89 @@
+#ifndef THREAD_POOL_H_INCLUDED
+#define THREAD_POOL_H_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed number of worker threads sharing one FIFO task queue,
+ * so busy and idle tasks are balanced over all workers.
+ * The init function is called once in each worker thread. */
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+
+    ThreadPool(unsigned int num_threads, Task thread_init = Task())
+    {
+        for (unsigned int i = 0; i < num_threads; ++i)
+            workers.emplace_back([this, thread_init]() {
+                if (thread_init) thread_init();
+                worker_loop();
+            });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopped = true;
+        }
+        cond.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    void submit(Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push_back(std::move(task));
+        }
+        cond.notify_one();
+    }
+
+    /* block until all submitted tasks are done */
+    void wait(void)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        idle.wait(lock, [this]() { return tasks.empty() and running == 0; });
+    }
+
+    std::size_t size(void) const { return workers.size(); }
+
+private:
+    void worker_loop(void)
+    {
+        for (;;) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cond.wait(lock, [this]() { return stopped or not tasks.empty(); });
+                if (stopped and tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                ++running;
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                --running;
+                if (tasks.empty() and running == 0) idle.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<Task>         tasks;
+    std::mutex               mtx;
+    std::condition_variable  cond;
+    std::condition_variable  idle;
+    unsigned int             running = 0;
+    bool                     stopped = false;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+#endif // THREAD_POOL_H_INCLUDED
@@ -11,12 +11,15 @@
 #include <robots/gretchen.h>
 #include <robots/gretchen_dev0.h>
 
+/* when no scene number is given explicitly, use the one from the global configuration. */
+void Bioloid::create_scene(Obstacle& obstacles, Landscape& landscape) { create_scene(obstacles, landscape, global_conf.scene); }
+
 void
-Bioloid::create_scene(Obstacle& obstacles, Landscape& landscape)
+Bioloid::create_scene(Obstacle& obstacles, Landscape& landscape, int index_number)
 {
-    assert(obstacles.number_of_objects() == 0);
+    assert(obstacles.number_of_objects() == 0 and obstacles.number_of_static_objects() == 0);
     dsPrint("Creating scene: ");
-    switch (global_conf.scene)
+    switch (index_number)
     {
         case 0: Scenes::create_empty_world();           break;
         case 1: Scenes::create_hurdles(obstacles);      break;
@@ -19,6 +19,7 @@ namespace Bioloid
     void create_robot(Robot& robot);
     void create_robot(Robot& robot, int index_number, std::vector<double> params);
     void create_scene(Obstacle& obstacles, Landscape& landscape);
+    void create_scene(Obstacle& obstacles, Landscape& landscape, int index_number);
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include <basic/color.h>
 #include <basic/common.h>
 #include <basic/draw.h>
+#include <build/collision.h>
 
 dMass add(dMass const& m0, dMass const& m1);
 
@@ -33,6 +34,8 @@ public:
     std::vector<Geometry_t> geometries; // geometries representing this body for collision
     Vector3      force_to_draw;
     dJointID     fixed_joint;
+    unsigned long category_bits; // collision filter of all geometries
+    unsigned long collide_bits;
 
 private:
     Solid(dWorldID const& world, unsigned body_id, std::string const& solid_name, Vector3 const& pos)
@@ -40,6 +43,8 @@ private:
     , name(solid_name)
     , force_to_draw(.0)
     , fixed_joint(nullptr)
+    , category_bits(collision::all)
+    , collide_bits(collision::all)
     {
         if (fabs(pos.x) > constants::max_position || fabs(pos.y) > constants::max_position || fabs(pos.z) > constants::max_position)
             dsError("Body is far too distant.\n");
@@ -84,6 +89,7 @@ public:
         dGeomSetBody(g.id, body);
         dGeomSetData (g.id, static_cast<void*>(&g.friction)); // save friction for near_callback
         if (!g.collision) dGeomDisable(g.id);
+        collision::set_filter(g.id, category_bits, collide_bits);
     }
 
     /* constructor for capsule segments */
@@ -134,6 +140,7 @@ public:
         dGeomSetBody(g.id, body);
         dGeomSetData (g.id, static_cast<void*>(&g.friction)); // save friction for near_callback
         if (!g.collision) dGeomDisable(g.id);
+        collision::set_filter(g.id, category_bits, collide_bits);
     }
 
     ~Solid()
@@ -184,6 +191,7 @@ public:
         dGeomSetBody(g.id, body);
         dGeomSetData (g.id, static_cast<void*>(&g.friction)); // save friction for near_callback
         if (!g.collision) dGeomDisable(g.id);
+        collision::set_filter(g.id, category_bits, collide_bits);
 
         dGeomSetOffsetPosition ( g.id
                                , rel.x - m_body.c[0]
@@ -238,6 +246,7 @@ public:
 	    dGeomSetBody(g.id, body);
 	    dGeomSetData (g.id, static_cast<void*>(&g.friction)); // save friction for near_callback
         if (!g.collision) dGeomDisable(g.id);
+        collision::set_filter(g.id, category_bits, collide_bits);
 
         if (1 == cap.dir) {
             dMatrix3 R;
@@ -258,6 +267,14 @@ public:
     }
 
 
+    void set_collision_filter(unsigned long category, unsigned long collide)
+    {
+        category_bits = category;
+        collide_bits  = collide;
+        for (auto const& g: geometries)
+            collision::set_filter(g.id, category_bits, collide_bits);
+    }
+
     void draw(bool bounding_box)
     {
         for (auto const& g: geometries) {
@@ -281,6 +298,8 @@ public:
 
     void set_impulse(const Vector3& force) { dBodyAddForce(body, force.x, force.y, force.z); force_to_draw = clip(0.1*force, 1.0); }
 
+    bool is_fixed(void) const { return fixed_joint != nullptr; }
+
     void toggle_fixed(const dWorldID& world)
     {
         if (fixed_joint == nullptr) {
@@ -301,11 +320,14 @@ class SolidVector
 public:
     SolidVector( const dWorldID&   world
                , const dSpaceID&   space
-               , const std::size_t max_number_of_bodies)
+               , const std::size_t max_number_of_bodies
+               , const unsigned long category = collision::all)
     : world(world)
     , space(space)
     , bodies()
     , max_number_of_bodies(max_number_of_bodies)
+    , category(category)
+    , collide(collision::collide_bits(category))
     {
         dsPrint("Creating body vector...");
         bodies.reserve(max_number_of_bodies);
@@ -327,6 +349,7 @@ public:
                 dsError("Name '%s' already in use.", name.c_str());
             }
             bodies.emplace_back(world, space, body_id, name, pos, friction, color, len, mass, density, collision);
+            bodies.back().set_collision_filter(category, collide);
         } else {
             dsError("Exceeded maximum number of bodies %u.", max_number_of_bodies);
         }
@@ -347,6 +370,7 @@ public:
                 dsError("Name '%s' already in use.", name.c_str());
             }
             bodies.emplace_back(world, space, body_id, name, pos, friction, color, cap, mass, density, collision);
+            bodies.back().set_collision_filter(category, collide);
         } else {
             dsError("Exceeded maximum number of bodies %u.", max_number_of_bodies);
         }
@@ -387,6 +411,12 @@ public:
         return total_mass;
     }
 
+    /* changes what all bodies, also the ones created later, collide with */
+    void set_collide_bits(unsigned long bits) {
+        collide = bits;
+        for (auto& b : bodies) b.set_collision_filter(category, collide);
+    }
+
     void destroy(void) {
         dsPrint("Destroying bodies (for recreation).\n");
         bodies.clear();
@@ -397,6 +427,8 @@ private:
     const dSpaceID&  space;
     std::vector<Solid> bodies;
     const std::size_t  max_number_of_bodies;
+    const unsigned long category; // collision filter
+    unsigned long       collide;
 };
 
 #endif // BODIES_H_INCLUDED
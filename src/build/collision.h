@@ -0,0 +1,38 @@
+#ifndef COLLISION_H_INCLUDED
+#define COLLISION_H_INCLUDED
+
+#include <ode/ode.h>
+
+/* Collision filter: every geom has a category and the categories it
+ * collides with. ODE's broadphase drops a pair unless one of the two geoms
+ * collides with the other's category, so such pairs never reach
+ * near_callback. */
+namespace collision {
+
+    const unsigned long robot      = 1 << 0; // the robot's body parts
+    const unsigned long attachment = 1 << 1; // additional body parts of the robot
+    const unsigned long scenery    = 1 << 2; // ground, heightfields and static obstacles
+    const unsigned long debris     = 1 << 3; // movable obstacles
+    const unsigned long all        = ~0ul;
+
+    /* The robot's parts collide with each other only if the robot enables
+     * self-collision, the scenery is never collided with itself. */
+    inline unsigned long collide_bits(unsigned long category, bool self_collision = false)
+    {
+        switch (category) {
+            case robot:
+            case attachment: return scenery | debris | (self_collision ? robot | attachment : 0);
+            case scenery:    return robot | attachment | debris;
+            default:         return all;
+        }
+    }
+
+    inline void set_filter(dGeomID geom, unsigned long category, unsigned long collide)
+    {
+        dGeomSetCategoryBits(geom, category);
+        dGeomSetCollideBits (geom, collide);
+    }
+
+} // namespace collision
+
+#endif // COLLISION_H_INCLUDED
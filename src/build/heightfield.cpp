@@ -1,6 +1,7 @@
 
 #include <build/heightfield.h>
 #include <basic/common.h>
+#include <build/collision.h>
 
 /* height field dimensions */
 const dReal HFIELD_WIDTH = 2.0;
@@ -34,6 +35,7 @@ Heightfield::Heightfield(const dSpaceID &space, const std::string name, const Ve
     // Give some very bounds which, while conservative,
     // makes AABB computation more accurate than +/-INF.
     geometry = dCreateHeightfield(space, heightid, 1);
+    collision::set_filter(geometry, collision::scenery, collision::collide_bits(collision::scenery));
     dGeomHeightfieldDataSetBounds(heightid, REAL(0.0), REAL(+5.0));
 
     // Rotate so Z is up, not Y (which is the default orientation)
@@ -133,6 +133,40 @@ NJoint::motor_model(const double u, double joint_speed) const
     return M;
 }
 
+void
+NJoint::get_state(double* s) const
+{
+    pid_ctrl.get_state(s);
+    s += PIDController::state_size;
+    s[0] = pid_enable;
+    s[1] = pid_maxtorque;
+    s[2] = pid_position_setpoint;
+    s[3] = voltage_setpoint;
+    s[4] = is_sticking;
+    s[5] = z;
+    s[6] = pos;
+    s[7] = vel;
+    s[8] = dpdt.last;
+    s[9] = dpdt.velocity;
+}
+
+void
+NJoint::set_state(const double* s)
+{
+    pid_ctrl.set_state(s);
+    s += PIDController::state_size;
+    pid_enable            = (s[0] != 0.0);
+    pid_maxtorque         = s[1];
+    pid_position_setpoint = s[2];
+    voltage_setpoint      = s[3];
+    is_sticking           = (s[4] != 0.0);
+    z                     = s[5];
+    pos                   = s[6];
+    vel                   = s[7];
+    dpdt.last             = s[8];
+    dpdt.velocity         = s[9];
+}
+
 dJointID create_fixed_joint(dWorldID const& world, SolidVector const& bodies, unsigned body1, unsigned body2)
 {
     dJointID fixed = dJointCreateFixed(world, 0);
@@ -14,8 +14,6 @@
 #include <build/params.h>
 #include <controller/pid_controller.h>
 
-extern Configuration global_conf;
-
 enum JointType {normal, symmetric};
 
 class NJoint
@@ -36,6 +34,7 @@ public:
           , const char axis
           , double torque_factor
           , ActuatorParameters const& conf
+          , Configuration const& settings
           )
     : joint_id(joint_id)
     , body1(body1)
@@ -47,15 +46,16 @@ public:
     , stop_lo(common::rad2norm(stop_lo_rad))
     , stop_hi(common::rad2norm(stop_hi_rad))
     , position_default(common::rad2norm(position_default_rad))
-    , pid_ctrl(global_conf.pidP, global_conf.pidI, global_conf.pidD, -0.5, 0.5)
+    , pid_ctrl(settings.pidP, settings.pidI, settings.pidD, -0.5, 0.5)
     , pid_enable(false)
-    , pid_maxtorque(global_conf.init_max_torque)
+    , pid_maxtorque(settings.init_max_torque)
+    , pid_maxtorque_default(pid_maxtorque)
     , pid_position_setpoint(position_default)
     , voltage_setpoint(0.0)
     , is_sticking(false)
     , z(.0)
     , conf(conf)
-    , dpdt(.0, global_conf.step_length, /*scale=*/1.0/constants::motor_parameter::vel_scale)
+    , dpdt(.0, settings.step_length, /*scale=*/1.0/constants::motor_parameter::vel_scale)
     {
         if (name == "") {
             name = "joint_" + std::to_string(joint_id);
@@ -118,11 +118,12 @@ public:
         dJointDestroy(motor);
     }
 
-    void read_sensors(bool low_quality)
+    /* dt: time since the sensors were last read */
+    void read_sensors(bool low_quality, double dt)
     {
         if (low_quality) {
             pos = common::avr_10bit_adc(get_position_norm());
-            dpdt.derive(pos);
+            dpdt.derive(pos, dt);
             vel = dpdt.get();
         } else {
             pos = common::low_resolution_sensor(get_position_norm());
@@ -130,6 +131,9 @@ public:
         }
     }
 
+    /* the next velocity of low quality sensors is derived from the current position */
+    void reset_sensors(void) { dpdt.reset(common::avr_10bit_adc(get_position_norm())); }
+
     /* lower resolution and noisy sensor outputs */
     double get_low_resolution_position(void) const { return pos; }
     double get_low_resolution_velocity(void) const { return vel; }
@@ -186,11 +190,12 @@ public:
 
     void reset() {
         pid_ctrl.reset();
-        set_motor_angular_velocity(0.0);
+        z = .0;
+        apply_friction(0.0); // initial static friction
         pid_enable = false;
         voltage_setpoint = 0.0;
         pid_position_setpoint = position_default;
-        pid_maxtorque = common::clip(global_conf.init_max_torque, 0.0, 1.0);
+        pid_maxtorque = common::clip(pid_maxtorque_default, 0.0, 1.0);
         pos = common::avr_10bit_adc(get_position_norm());
         dpdt.reset(pos);
         vel = .0;
@@ -198,6 +203,11 @@ public:
 
     void reinit_motormodel(ActuatorParameters const& c) { conf = c; }
 
+    /* controller, friction and sensor state, see GETSTATE */
+    static const std::size_t state_size = PIDController::state_size + 10;
+    void get_state(double* s) const;
+    void set_state(const double* s);
+
     void draw(void) const;
 
     const unsigned int joint_id;
@@ -219,6 +229,7 @@ private:
 
     bool               pid_enable;
     double             pid_maxtorque;
+    double             pid_maxtorque_default; // configured for the world
     double             pid_position_setpoint;
 
     double             voltage_setpoint;
@@ -237,9 +248,10 @@ private:
 class JointVector
 {
 public:
-    JointVector(const std::size_t max_number_of_joints)
+    JointVector(const std::size_t max_number_of_joints, Configuration const& settings)
     : joints()
     , max_number_of_joints(max_number_of_joints)
+    , settings(settings)
     {
         dsPrint("Creating joint vector...");
         joints.reserve(max_number_of_joints);
@@ -270,7 +282,7 @@ public:
         if (joint_id < max_number_of_joints)
             joints.emplace_back( world, bodies, joint_id, body1, body2, type, name
                                , stopLo_rad, stopHi_rad, position_default_rad, rel
-                               , axis, torque_factor, conf );
+                               , axis, torque_factor, conf, settings );
         else
             dsError("Maximum number of joints is %u.", max_number_of_joints);
 
@@ -289,6 +301,8 @@ public:
             joints[idx].reset();
     }
 
+    void reset_sensors_all(void) { for (auto& j : joints) j.reset_sensors(); }
+
     void apply_control_all(void) {
         for (unsigned int idx = 0; idx < get_size(); ++idx)
             joints[idx].apply_control();
@@ -302,6 +316,7 @@ public:
 private:
     std::vector<NJoint> joints;
     const std::size_t   max_number_of_joints;
+    Configuration const& settings; // PID and step length of new joints
 
 };
 
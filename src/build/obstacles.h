@@ -8,25 +8,75 @@
 #include <basic/vector3.h>
 #include <build/physics.h>
 #include <build/bodies.h>
+#include <basic/draw.h>
 
 /* This file contains the primitives
  * for obstacles and environmental objects */
 
+/* a box of the scenery, a geom without body, which never moves and
+ * adds nothing to the constraint solver */
+class StaticBox {
+public:
+    StaticBox(const dSpaceID &space, const Vector3 pos, const Vector3 len, const Color4 color, dReal friction)
+    : geom(dCreateBox(space, len.x, len.y, len.z))
+    , color(color)
+    , friction(friction)
+    {
+        if (fabs(pos.x) > constants::max_position || fabs(pos.y) > constants::max_position || fabs(pos.z) > constants::max_position)
+            dsError("Static box is far too distant.\n");
+
+        dGeomSetPosition(geom, pos.x, pos.y, pos.z);
+        dGeomSetData(geom, static_cast<void*>(&this->friction)); // save friction for near_callback
+        collision::set_filter(geom, collision::scenery, collision::collide_bits(collision::scenery));
+    }
+
+    /* takes over the geom, which then points to the new friction */
+    StaticBox(StaticBox&& other) noexcept
+    : geom(other.geom)
+    , color(other.color)
+    , friction(other.friction)
+    {
+        other.geom = nullptr;
+        dGeomSetData(geom, static_cast<void*>(&this->friction));
+    }
+
+    ~StaticBox() { if (geom) dGeomDestroy(geom); }
+
+    void draw(bool bounding_box) const {
+        dsSetColorAlpha(color.r, color.g, color.b, color.a);
+        drawGeom(geom, 0, 0, bounding_box);
+    }
+
+    dGeomID geom;
+    Color4  color;
+    dReal   friction; // 0..Inf
+
+private:
+    StaticBox(const StaticBox&) = delete;
+    StaticBox& operator=(const StaticBox&) = delete;
+};
+
 class Obstacle {
 public:
-    Obstacle(const dWorldID &world, const dSpaceID &space)
+    Obstacle(const dWorldID &world, const dSpaceID &space, const dSpaceID &static_space)
     : world(world)
     , space(space)
-    , objects(world, space, constants::max_obstacles)
+    , static_space(static_space)
+    , objects(world, space, constants::max_obstacles, collision::debris)
+    , static_objects()
     {
         dsPrint("Creating obstacles.\n");
+        static_objects.reserve(constants::max_obstacles);
     }
     const dWorldID&  world;
     const dSpaceID&  space;
+    const dSpaceID&  static_space;
 
     SolidVector objects;
+    std::vector<StaticBox> static_objects; // not part of snapshots, they never move
 
     std::size_t number_of_objects() const { return objects.size(); }
+    std::size_t number_of_static_objects() const { return static_objects.size(); }
 
     void create_box( std::string name
                    , const Vector3 pos
@@ -39,20 +89,19 @@ public:
         objects.create_box(name, pos, len, mass, density, color, true, friction);
     }
 
-    void create_fixed_box(std::string name,
-                          const Vector3 pos,
-                          const Vector3 len,
-                          const dReal mass,
-                          const dReal density,
-                          const Color4 color,
-                          dReal friction = dInfinity)
+    void create_static_box( const Vector3 pos
+                          , const Vector3 len
+                          , const Color4 color
+                          , dReal friction = dInfinity)
     {
-        objects.create_box(name, pos, len, mass, density, color, true, friction);
-        objects[objects.size() - 1].toggle_fixed(world); // fix object last created
+        if (static_objects.size() < constants::max_obstacles)
+            static_objects.emplace_back(static_space, pos, len, color, friction);
+        else
+            dsError("Maximum number of static obstacles is %u.", constants::max_obstacles);
     }
 
     void print_statistics(void) const {
-        dsPrint("   Obstacles: %d, Total Mass of Obstacles: %1.3f kg\n", number_of_objects(), objects.get_total_mass().mass);
+        dsPrint("   Obstacles: %d, Total Mass of Obstacles: %1.3f kg, Static Obstacles: %d\n", number_of_objects(), objects.get_total_mass().mass, number_of_static_objects());
     }
 
     ~Obstacle() {
@@ -61,6 +110,7 @@ public:
 
     void destroy(void) {
         objects.destroy();
+        static_objects.clear();
     }
 
 };
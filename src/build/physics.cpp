@@ -1,35 +1,169 @@
+#include <cmath>
 #include <build/physics.h>
 
 /**TODO: where can we set friction of the groundplane or heightfield? */
 
+void physics::step(const double step_length)
+{
+    ++collision_steps;
+    dSpaceCollide(space, this, &near_callback); // collision detection
+    if (quick_step)
+        dWorldQuickStep(world, step_length);    // iterative world simulation step
+    else
+        dWorldStep(world, step_length);         // world simulation step
+    dJointGroupEmpty(contactgroup);             // remove all contact joints
+}
+
+namespace {
+    /* union of the finite AABBs of a space's geoms, without sub-spaces,
+       and the size of the largest geom */
+    struct Bounds {
+        dReal lo[3] = { dInfinity,  dInfinity,  dInfinity};
+        dReal hi[3] = {-dInfinity, -dInfinity, -dInfinity};
+        dReal largest = 0;
+
+        void add(dSpaceID space) {
+            for (int i = 0; i < dSpaceGetNumGeoms(space); ++i) {
+                const dGeomID g = dSpaceGetGeom(space, i);
+                if (dGeomIsSpace(g)) continue;
+
+                dReal aabb[6];
+                dGeomGetAABB(g, aabb);
+                if (not std::isfinite(aabb[0] + aabb[1] + aabb[2] + aabb[3] + aabb[4] + aabb[5])) continue; // ground plane
+
+                dReal size = 0;
+                for (int k = 0; k < 3; ++k) {
+                    lo[k] = std::min(lo[k], aabb[2*k]);
+                    hi[k] = std::max(hi[k], aabb[2*k+1]);
+                    size  = std::max(size, aabb[2*k+1] - aabb[2*k]);
+                }
+                largest = std::max(largest, size);
+            }
+        }
+        bool empty(void) const { return largest <= 0; }
+    };
+
+    /* a single level of cells fitting the largest geom, searching fewer
+       levels beats finer cells for the few small geoms (bench/collision_spaces.cpp) */
+    void tune_hash_levels(dSpaceID space)
+    {
+        Bounds bounds;
+        bounds.add(space);
+        if (bounds.empty()) return;
+
+        const int level = std::ceil(std::log2(bounds.largest));
+        dHashSpaceSetLevels(space, level, level);
+    }
+
+    dSpaceID create_space(std::string const& type, dSpaceID parent, Bounds const& bounds)
+    {
+        if (type == "sap")
+            return dSweepAndPruneSpaceCreate(parent, dSAP_AXES_YXZ); // scenes extend along y
+
+        dVector3 center = {0, 0, 0}, extents = {0, 0, 0};
+        for (int k = 0; k < 3 and not bounds.empty(); ++k) {
+            center [k] = 0.5 * (bounds.lo[k] + bounds.hi[k]);
+            extents[k] = 0.5 * (bounds.hi[k] - bounds.lo[k]);
+        }
+        for (int k = 0; k < 3; ++k)
+            extents[k] += constants::quadtree_margin;
+        return dQuadTreeSpaceCreate(parent, center, extents, constants::quadtree_depth);
+    }
+
+    void move_geoms(dSpaceID from, dSpaceID to)
+    {
+        while (dSpaceGetNumGeoms(from) > 0) {
+            const dGeomID g = dSpaceGetGeom(from, 0);
+            dSpaceRemove(from, g);
+            dSpaceAdd(to, g);
+        }
+    }
+}
+
+void physics::fit_space(Configuration const& conf)
+{
+    std::string const& type = conf.collision_space;
+
+    if (type != "sap" and type != "quadtree") {
+        if (type != "hash")
+            dsPrint("Warning: unknown collision space '%s', using hash.\n", type.c_str());
+        tune_hash_levels(space);
+        tune_hash_levels(static_space);
+        dsPrint("Collision space: hash.\n");
+        return;
+    }
+
+    Bounds bounds;
+    bounds.add(space);
+    bounds.add(static_space);
+
+    const dSpaceID new_space        = create_space(type, 0        , bounds);
+    const dSpaceID new_static_space = create_space(type, new_space, bounds);
+
+    dSpaceRemove(space, (dGeomID) static_space);
+    move_geoms(static_space, new_static_space);
+    move_geoms(space, new_space);
+    dSpaceDestroy(static_space);
+    dSpaceDestroy(space);
+
+    space        = new_space;
+    static_space = new_static_space;
+    collision::set_filter((dGeomID) static_space, collision::scenery, collision::collide_bits(collision::scenery));
+    dsPrint("Collision space: %s.\n", type.c_str());
+}
+
+void physics::reset_space(void)
+{
+    if (dSpaceGetClass(space) == dHashSpaceClass)
+        return; // not replaced by fit_space
+
+    if (dSpaceGetNumGeoms(space) != 1 or dSpaceGetNumGeoms(static_space) != 1)
+        dsDebug("Collision spaces still hold geoms of the former model.\n");
+
+    dGeomDestroy(ground);
+    dSpaceDestroy(space); // and the nested static space
+    create_spaces();
+}
+
 /* this is called by dSpaceCollide when two objects in space are potentially colliding */
 void near_callback(void *data, dGeomID o1, dGeomID o2)
 {
+    /* the static space against a geom of the robot or an obstacle,
+       the static geoms are never collided with each other */
+    if (dGeomIsSpace(o1) or dGeomIsSpace(o2)) {
+        dSpaceCollide2(o1, o2, data, &near_callback);
+        return;
+    }
+
     physics *universe = static_cast<physics *>(data);
+    ++universe->collision_pairs;
 
     dBodyID b1 = dGeomGetBody(o1);
     dBodyID b2 = dGeomGetBody(o2);
 
+    /* exit without doing anything if the two bodies are connected by a joint */
+    if (b1 && b2 && dAreConnectedExcluding(b1, b2, dJointTypeContact)) return;
+
+    dContact contact[constants::max_contacts];   // up to constants::max_contacts contacts per box-box
+    const int numc = dCollide (o1, o2, constants::max_contacts, &contact[0].geom, sizeof(dContact));
+    if (numc == 0) return;
+    universe->contacts += numc;
+
     dReal mu1 = 1;
     dReal mu2 = 1;
 
-    if (!dGeomIsSpace(o1)) {
-        dReal *friction1 = static_cast<dReal*>(dGeomGetData(o1));
-        if (friction1 != NULL)
-            mu1 = *friction1;
-    }
-    if (!dGeomIsSpace(o2)) {
-        dReal *friction2 = static_cast<dReal*>(dGeomGetData(o2));
-        if (friction2 != NULL)
-            mu2 = *friction2;
-    }
+    dReal *friction1 = static_cast<dReal*>(dGeomGetData(o1));
+    if (friction1 != NULL)
+        mu1 = *friction1;
+    dReal *friction2 = static_cast<dReal*>(dGeomGetData(o2));
+    if (friction2 != NULL)
+        mu2 = *friction2;
 
+    dMatrix3 RI;
+    dRSetIdentity (RI);
+    const dReal size[3] = {0.02, 0.02, 0.02};
 
-    /* exit without doing anything if the two bodies are connected by a joint */
-    if (b1 && b2 && dAreConnectedExcluding(b1, b2, dJointTypeContact)) return;
-
-    dContact contact[constants::max_contacts];   // up to constants::max_contacts contacts per box-box
-    for (unsigned int i = 0; i < constants::max_contacts; ++i)
+    for (int i = 0; i < numc; ++i)
     {
         contact[i].surface.mode = dContactSoftCFM | dContactSoftERP
         // | dContactApprox1
@@ -40,22 +174,12 @@ void near_callback(void *data, dGeomID o1, dGeomID o2)
         contact[i].surface.mu = std::max(mu1, mu2); // dInfinity = extreme sticky objects
         contact[i].surface.slip1 = 0.001;
         contact[i].surface.slip2 = 0.001;
-        contact[i].surface.soft_cfm = global_conf.contact_soft_CFM;
-        contact[i].surface.soft_erp = global_conf.contact_soft_ERP;
-    }
+        contact[i].surface.soft_cfm = universe->conf.contact_soft_CFM;
+        contact[i].surface.soft_erp = universe->conf.contact_soft_ERP;
 
-    if (int numc = dCollide (o1, o2, constants::max_contacts, &contact[0].geom, sizeof(dContact)))
-    {
-        dMatrix3 RI;
-        dRSetIdentity (RI);
-        const dReal size[3] = {0.02, 0.02, 0.02};
-
-        for (int i = 0; i < numc; ++i)
-        {
-            dJointID c = dJointCreateContact(universe->world, universe->contactgroup, contact + i);
-            dJointAttach (c, b1, b2);
-            if (!global_conf.disable_graphics && global_conf.show_contacts)
-                dsDrawBox ((const double *) contact[i].geom.pos, (const double *) RI, (const double *) size);
-        }
+        dJointID c = dJointCreateContact(universe->world, universe->contactgroup, contact + i);
+        dJointAttach (c, b1, b2);
+        if (!universe->conf.disable_graphics && universe->conf.show_contacts)
+            dsDrawBox ((const double *) contact[i].geom.pos, (const double *) RI, (const double *) size);
     }
 }
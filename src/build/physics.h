@@ -6,6 +6,7 @@
 #include <draw/drawstuff.h>
 #include <basic/configuration.h>
 #include <basic/constants.h>
+#include <build/collision.h>
 
 extern Configuration global_conf;
 
@@ -13,20 +14,21 @@ void near_callback(void *data, dGeomID o1, dGeomID o2);
 
 class physics {
 public:
-    physics()
+    physics(Configuration const& conf = global_conf)
+    : conf(conf)
     {
-        dsPrint("Creating the world.\n");
-        dInitODE();
+        dsPrint("Creating the world.\n"); // ODE is initialized by main or the session server
         world = dWorldCreate();
-        space = dHashSpaceCreate(0);
-        ground = dCreatePlane (space, 0, 0, 1, 0); // plane equation is 0x + 0y + 1z = 0
+        create_spaces();
         contactgroup = dJointGroupCreate(0);
+        reset_collision_counts();
 
         /* init Gravity on/off */
-        set_gravity(global_conf.initial_gravity);
+        set_gravity(conf.initial_gravity);
 
         dWorldSetCFM (world, constants::world_CFM);
         dWorldSetERP (world, constants::world_ERP);
+        set_solver(conf);
 
         dsPrint("The world has been created.\n");
     }
@@ -35,13 +37,43 @@ public:
         dsPrint("Destroying ground, world and space.\n");
         dJointGroupDestroy(contactgroup);
         dGeomDestroy(ground);
-        dSpaceDestroy(space);
+        dSpaceDestroy(space); // and the nested static space
         dWorldDestroy(world);
-        dsPrint("All has been destroyed. Closing ODE.\n");
-        dCloseODE();
+        dsPrint("All has been destroyed.\n");
         dsPrint("All done, Simloid says goodbye______\n");
     }
 
+    void step(const double step_length); // collision detection and one world step
+
+    /* dWorldStep is exact and O(n^3) in the constraints, dWorldQuickStep
+       iterates and is O(n), for many contacts and obstacles */
+    void set_solver(Configuration const& conf) {
+        quick_step = conf.quick_step;
+        dWorldSetQuickStepNumIterations(world, conf.quickstep_iterations);
+        dWorldSetQuickStepW            (world, conf.quickstep_SOR);
+    }
+
+    /* Replaces the spaces by the configured type (hash, sap or quadtree),
+       tuned to the bounds and sizes of the geoms. Call after the robot and
+       the scene are built. */
+    void fit_space(Configuration const& conf);
+
+    /* Back to the hash spaces and ground of a new world, before a model is
+       rebuilt and fitted again. Call after the robot and the scene are
+       destroyed, the ground is the only geom left. It is created anew, a geom
+       once removed from a sap space can not be added to another one. */
+    void reset_space(void);
+
+    /* pairs passed to near_callback by the broadphase and the contacts
+       created from them, since the last reset */
+    void reset_collision_counts(void) { collision_steps = collision_pairs = contacts = 0; }
+
+    void print_collision_counts(void) const {
+        if (collision_steps == 0) return;
+        dsPrint("Collision: %.1f pairs and %.1f contacts per step (%lu steps).\n"
+               , double(collision_pairs) / collision_steps, double(contacts) / collision_steps, collision_steps);
+    }
+
     void set_gravity(bool enable) const {
         if (enable) {
             dWorldSetGravity (world, .0, .0, -constants::gravity);
@@ -52,10 +84,33 @@ public:
         }
     }
 
+    bool has_gravity(void) const {
+        dVector3 g;
+        dWorldGetGravity(world, g);
+        return g[2] != .0;
+    }
+
+    Configuration const& conf; // of the session which owns the world
+
     dWorldID       world;
-    dSpaceID       space;
+    dSpaceID       space;        // robot and movable obstacles
+    dSpaceID       static_space; // ground, heightfields and fixed obstacles, nested in space
     dGeomID        ground;
     dJointGroupID  contactgroup;
+    bool           quick_step;
+
+    unsigned long  collision_steps; // counted by step and near_callback
+    unsigned long  collision_pairs;
+    unsigned long  contacts;
+
+private:
+    void create_spaces(void) {
+        space = dHashSpaceCreate(0);
+        static_space = dHashSpaceCreate(space);
+        ground = dCreatePlane (static_space, 0, 0, 1, 0); // plane equation is 0x + 0y + 1z = 0
+        collision::set_filter((dGeomID) static_space, collision::scenery, collision::collide_bits(collision::scenery));
+        collision::set_filter(ground                , collision::scenery, collision::collide_bits(collision::scenery));
+    }
 };
 
 #endif // PHYSICS_H_INCLUDED
@@ -121,14 +121,15 @@ void Robot::print_statistics(void) const
 {
     auto const total = add(bodies.get_total_mass(), attachments.get_total_mass());
 
-    dsPrint("Robot statistics:\n   Bodies: %lu\n   Joints: %lu\n   Accels: %lu\n   Weight: %.3lf kg\n   CoM: (%.2lf, %.2lf, %.2lf)\n\n"
+    dsPrint("Robot statistics:\n   Bodies: %lu\n   Joints: %lu\n   Accels: %lu\n   Weight: %.3lf kg\n   CoM: (%.2lf, %.2lf, %.2lf)\n   Self-collision: %s\n\n"
            , number_of_bodies()
            , number_of_joints()
            , number_of_accels()
            , total.mass
            , total.c[0]
            , total.c[1]
-           , total.c[2] );
+           , total.c[2]
+           , self_collision ? "on" : "off" );
 }
 
 void Robot::set_camera_center_on(std::string const& bodyname)
@@ -29,17 +29,18 @@ namespace detail {
 
 class Robot {
 public:
-    Robot(const dWorldID &world, const dSpaceID &space)
+    Robot(const dWorldID &world, const dSpaceID &space, Configuration const& conf = global_conf)
     : world(world)
     , space(space)
-    , bodies(world, space, constants::max_bodies)
-    , joints(constants::max_joints)
+    , bodies(world, space, constants::max_bodies, collision::robot)
+    , joints(constants::max_joints, conf)
     , accels(constants::max_accels)
-    , attachments(world, space, constants::max_bodies)
+    , attachments(world, space, constants::max_bodies, collision::attachment)
     , description(detail::default_description)
     , cam_center_obj(0)
     , cam_setup(Vector3(0.3,-0.3,0.3), 130.,-18.,0.)
     , model_id()
+    , self_collision(false)
     { }
     const dWorldID&  world;
     const dSpaceID&  space;
@@ -146,6 +147,15 @@ public:
         b.add_segment(space, rel, cap, mass, density, color, collision, friction);
     }
 
+    /* Body parts not connected by a joint collide with each other only
+       with self-collision, robots whose limbs can touch enable it. */
+    void set_self_collision(bool enable) {
+        self_collision = enable;
+        bodies     .set_collide_bits(collision::collide_bits(collision::robot     , enable));
+        attachments.set_collide_bits(collision::collide_bits(collision::attachment, enable));
+    }
+    bool has_self_collision(void) const { return self_collision; }
+
     void print_statistics(void) const;
 
     void set_camera_center_on(std::string const& name_body);
@@ -188,6 +198,7 @@ public:
         joints.destroy();
         accels.destroy();
         attachments.destroy();
+        set_self_collision(false);
         description = detail::default_description;
     }
 
@@ -196,6 +207,7 @@ private:
     Camera_Setup cam_setup;
 
     ModelID model_id;
+    bool    self_collision;
 };
 
 
@@ -0,0 +1,120 @@
+#ifndef BINARY_PROTOCOL_H_INCLUDED
+#define BINARY_PROTOCOL_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <basic/constants.h>
+
+/* Binary framed protocol, negotiated with 'BINARY MODE' after the traits handshake.
+ *
+ * Inbound (client -> simloid):
+ *   [opcode:uint8][count:uint32][count * float64 or count * float32]
+ *   Text commands (DONE, RESET, ...) are still accepted. They always start with a
+ *   printable character, so a first byte which is an opcode (see is_opcode, with
+ *   or without float32_flag) introduces a binary frame.
+ *
+ * Outbound (simloid -> client):
+ *   [length:uint32][type:uint32][length bytes of payload]
+ *
+ * All values are little-endian.
+ */
+namespace binary_protocol {
+
+    enum Opcode : uint8_t {
+        UX = 0x01, // voltages,      count = batch size * number of joints
+        PX = 0x02, // PID setpoints, count = batch size * number of joints
+        TX = 0x03, // max. torques,  count = batch size * number of joints
+        FX = 0x04, // forces,        count = batch size * 3 * number of bodies
+
+        ROLLOUT         = 0x05, // K voltage vectors, count = K * number of joints
+        ROLLOUT_RESTORE = 0x06, // same, restores the user snapshot afterwards
+    };
+
+    const uint8_t float32_flag = 0x10; // set in opcode, if payload is float32 instead of float64
+
+    const std::size_t command_header_size = 5;
+    const std::size_t frame_header_size   = 8;
+    /* limit of inbound frames, the largest are FX of a full batch and a ROLLOUT */
+    const uint32_t    max_values          = std::max( constants::max_batch_size * 3 * constants::max_bodies
+                                                    , constants::max_rollout_steps * constants::max_joints );
+
+    enum FrameType : uint32_t {
+        status  = 0x54415453, // "STAT"
+        rollout = 0x4c4c4f52, // "ROLL", K status records
+
+        /* compressed status, see status_compression.h */
+        keyframe = 0x4659454b, // "KEYF", int32 quantized values
+        delta    = 0x544c4544, // "DELT", int16 differences to the previous frame
+
+        state    = 0x50414e53, // "SNAP", simulator state, reply to GETSTATE (see snapshot.h)
+        observer = 0x5653424f, // "OBSV", sequence number and status, UDP broadcast (see observer.h)
+        deadlines = 0x534e4c44, // "DLNS", deadline statistics, reply to DEADLINES
+    };
+
+    inline bool is_opcode(const char c) {
+        const uint8_t op = static_cast<uint8_t>(c) & ~float32_flag;
+        return (op >= UX) and (op <= ROLLOUT_RESTORE);
+    }
+
+    inline std::size_t value_size(const uint8_t opcode) { return (opcode & float32_flag) ? sizeof(float) : sizeof(double); }
+
+    /* little-endian encoding */
+    inline void put_u32(std::string& buf, uint32_t v) {
+        char b[4];
+        for (unsigned i = 0; i < 4; ++i) b[i] = static_cast<char>((v >> (8*i)) & 0xff);
+        buf.append(b, 4);
+    }
+
+    inline void put_f64(std::string& buf, double value) {
+        uint64_t v;
+        memcpy(&v, &value, sizeof(v));
+        char b[8];
+        for (unsigned i = 0; i < 8; ++i) b[i] = static_cast<char>((v >> (8*i)) & 0xff);
+        buf.append(b, 8);
+    }
+
+    /* outbound frames: write header first, patch payload length when done */
+    inline void begin_frame(std::string& buf, FrameType type) {
+        buf.clear();
+        put_u32(buf, 0);
+        put_u32(buf, type);
+    }
+
+    inline void end_frame(std::string& buf) {
+        const uint32_t length = buf.size() - frame_header_size;
+        for (unsigned i = 0; i < 4; ++i) buf[i] = static_cast<char>((length >> (8*i)) & 0xff);
+    }
+
+    inline uint32_t get_u32(const char* b) {
+        uint32_t v = 0;
+        for (unsigned i = 0; i < 4; ++i) v |= static_cast<uint32_t>(static_cast<uint8_t>(b[i])) << (8*i);
+        return v;
+    }
+
+    inline double get_f64(const char* b) {
+        uint64_t v = 0;
+        for (unsigned i = 0; i < 8; ++i) v |= static_cast<uint64_t>(static_cast<uint8_t>(b[i])) << (8*i);
+        double value;
+        memcpy(&value, &v, sizeof(value));
+        return value;
+    }
+
+    inline double get_f32(const char* b) {
+        const uint32_t v = get_u32(b);
+        float value;
+        memcpy(&value, &v, sizeof(value));
+        return value;
+    }
+
+    /* decode one value of an inbound frame, depending on the opcode's precision */
+    inline double get_value(const char* payload, std::size_t idx, uint8_t opcode) {
+        return (opcode & float32_flag) ? get_f32(payload + idx*sizeof(float))
+                                       : get_f64(payload + idx*sizeof(double));
+    }
+
+} // namespace binary_protocol
+
+#endif // BINARY_PROTOCOL_H_INCLUDED
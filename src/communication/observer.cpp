@@ -0,0 +1,95 @@
+#include <chrono>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <communication/observer.h>
+
+bool ObserverBroadcast::open(std::string const& address, int port)
+{
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        printf("ERROR: invalid observer address '%s'.\n", address.c_str());
+        return false;
+    }
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        printf("ERROR opening observer socket: %s\n", strerror(errno));
+        return false;
+    }
+
+    /* multicast stays on this host unless the TTL is raised */
+    if (IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+        const unsigned char ttl = 0, loop = 1;
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL , &ttl , sizeof(ttl));
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+
+    slots.assign(capacity, std::string());
+    running = true;
+    sender = std::thread(&ObserverBroadcast::send_loop, this);
+
+    printf("Broadcasting status to observers at %s:%d.\n", address.c_str(), port);
+    return true;
+}
+
+void ObserverBroadcast::close(void)
+{
+    if (sender.joinable()) {
+        running = false;
+        sender.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void ObserverBroadcast::publish(std::vector<double> const& values)
+{
+    using namespace binary_protocol;
+
+    const uint32_t seq = sequence++;
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::string& frame = slots[h % capacity];
+    begin_frame(frame, observer);
+    put_u32(frame, seq);
+    for (double v : values) put_f64(frame, v);
+    end_frame(frame);
+
+    head.store(h + 1, std::memory_order_release);
+}
+
+void ObserverBroadcast::send_loop(void)
+{
+    while (running.load(std::memory_order_relaxed))
+    {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        std::string const& frame = slots[t % capacity];
+        /* nobody listening is not an error, datagrams are just lost */
+        if (frame.size() <= max_datagram
+            and sendto(fd, frame.data(), frame.size(), MSG_DONTWAIT, (struct sockaddr*) &addr, sizeof(addr)) >= 0)
+            sent.fetch_add(1, std::memory_order_relaxed);
+        else
+            dropped.fetch_add(1, std::memory_order_relaxed);
+
+        tail.store(t + 1, std::memory_order_release);
+    }
+}
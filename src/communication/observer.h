@@ -0,0 +1,58 @@
+#ifndef OBSERVER_H_INCLUDED
+#define OBSERVER_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netinet/in.h>
+
+#include <communication/binary_protocol.h>
+
+/* Broadcast of the status to monitoring clients (dashboards, loggers) as UDP
+ * datagrams, to a local port or a multicast group. The control loop only
+ * copies the status into a single-producer single-consumer ring, a sender
+ * thread writes the datagrams. A full ring drops the frame, so slow or
+ * absent observers never stall the physics.
+ *
+ * Datagram, little-endian: uint32 payload length, uint32 frame type
+ * 0x5653424f ("OBSV"), uint32 sequence number, float64 status values.
+ * Gaps in the sequence numbers are dropped or lost frames. */
+class ObserverBroadcast {
+public:
+    ObserverBroadcast() : fd(-1), addr(), slots(), head(0), tail(0), running(false), sender(), sequence(0), sent(0), dropped(0) {}
+    ~ObserverBroadcast() { close(); }
+
+    bool open(std::string const& address, int port);
+    void close(void);
+
+    void publish(std::vector<double> const& values); // never blocks, called by the control loop
+
+    uint64_t frames_sent   (void) const { return sent.load(std::memory_order_relaxed); }
+    uint64_t frames_dropped(void) const { return dropped.load(std::memory_order_relaxed); }
+
+    static const std::size_t capacity     = 64;    // frames in the ring
+    static const std::size_t max_datagram = 65507; // UDP payload limit
+
+private:
+    void send_loop(void);
+
+    int fd;
+    struct sockaddr_in addr;
+
+    std::vector<std::string> slots;  // frames, reused
+    std::atomic<uint64_t> head;      // next slot to write, producer only
+    std::atomic<uint64_t> tail;      // next slot to send, consumer only
+    std::atomic<bool>     running;
+    std::thread           sender;
+    uint32_t              sequence;  // of published frames, including dropped ones
+
+    std::atomic<uint64_t> sent;
+    std::atomic<uint64_t> dropped;
+
+    ObserverBroadcast(const ObserverBroadcast&) = delete;
+    ObserverBroadcast& operator=(const ObserverBroadcast&) = delete;
+};
+
+#endif // OBSERVER_H_INCLUDED
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstring>
+
+#include <communication/binary_protocol.h>
+#include <communication/session_record.h>
+
+using namespace binary_protocol;
+
+namespace {
+    void put_u64(std::string& buf, uint64_t v) {
+        put_u32(buf, static_cast<uint32_t>(v));
+        put_u32(buf, static_cast<uint32_t>(v >> 32));
+    }
+
+    uint64_t get_u64(const char* b) {
+        return static_cast<uint64_t>(get_u32(b)) | (static_cast<uint64_t>(get_u32(b + 4)) << 32);
+    }
+}
+
+bool SessionRecorder::open(std::string const& filename, Configuration const& conf)
+{
+    file = fopen(filename.c_str(), "wb");
+    if (nullptr == file) {
+        printf("ERROR: Cannot create session record '%s'.\n", filename.c_str());
+        return false;
+    }
+
+    const uint32_t flags = (conf.pipelined_mode    ? session_record::pipelined_mode    : 0)
+                         | (conf.persistent_server ? session_record::persistent_server : 0)
+                         | (conf.initial_gravity   ? session_record::initial_gravity   : 0);
+    buf.assign(session_record::magic, sizeof(session_record::magic));
+    put_u32(buf, session_record::version);
+    put_u32(buf, conf.robot);
+    put_u32(buf, conf.scene);
+    put_u32(buf, conf.steps_per_control);
+    put_u32(buf, flags);
+    put_f64(buf, conf.step_length);
+
+    start = std::chrono::steady_clock::now();
+    return fwrite(buf.data(), 1, buf.size(), file) == buf.size();
+}
+
+void SessionRecorder::record(const char* data, std::size_t length)
+{
+    if (nullptr == file) return;
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    buf.clear();
+    put_u64(buf, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    put_u32(buf, length);
+    fwrite(buf.data(), 1, buf.size(), file);
+    fwrite(data, 1, length, file);
+
+    if (0 == length) fflush(file); // keep complete sessions, if the server is killed later
+}
+
+bool ReplayTransport::load(std::string const& filename)
+{
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (nullptr == file) {
+        printf("ERROR: Cannot open session record '%s'.\n", filename.c_str());
+        return false;
+    }
+    char chunk[1 << 16];
+    std::size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    fclose(file);
+
+    if (data.size() < session_record::header_size
+        or memcmp(data.data(), session_record::magic, sizeof(session_record::magic)) != 0
+        or get_u32(&data[8]) != session_record::version)
+    {
+        printf("ERROR: '%s' is not a session record of this version.\n", filename.c_str());
+        data.clear();
+        return false;
+    }
+
+    /* check the records and take the recorded duration */
+    uint64_t first = 0, last = 0;
+    std::size_t p = session_record::header_size;
+    while (p + session_record::record_header_size <= data.size()) {
+        const std::size_t next = p + session_record::record_header_size + get_u32(&data[p + 8]);
+        if (next > data.size()) break;
+
+        const uint64_t t = get_u64(&data[p]);
+        if (p == session_record::header_size) first = t;
+        last = t;
+        p = next;
+    }
+    if (p != data.size()) {
+        printf("Warning: session record '%s' is truncated.\n", filename.c_str());
+        data.resize(p);
+    }
+    recorded_ns = last - first;
+    pos = session_record::header_size;
+    return true;
+}
+
+void ReplayTransport::apply_settings(Configuration& conf) const
+{
+    const char* h = data.data() + sizeof(session_record::magic) + 4;
+    const uint32_t flags   = get_u32(h + 12);
+    conf.robot             = static_cast<int32_t>(get_u32(h));
+    conf.scene             = static_cast<int32_t>(get_u32(h + 4));
+    conf.steps_per_control = static_cast<int32_t>(get_u32(h + 8));
+    conf.pipelined_mode    = flags & session_record::pipelined_mode;
+    conf.persistent_server = flags & session_record::persistent_server;
+    conf.initial_gravity   = flags & session_record::initial_gravity;
+    conf.step_length       = get_f64(h + 16);
+}
+
+std::size_t ReplayTransport::receive(char* dest, std::size_t max)
+{
+    if (0 == chunk_left) {
+        if (pos >= data.size()) return 0; // end of recording, disconnect
+
+        chunk_left = get_u32(&data[pos + 8]);
+        pos += session_record::record_header_size;
+        if (0 == chunk_left) return 0; // recorded disconnect
+    }
+
+    const std::size_t n = std::min(chunk_left, max);
+    memcpy(dest, &data[pos], n);
+    pos            += n;
+    chunk_left     -= n;
+    bytes_received += n;
+    return n;
+}
+
+bool ReplayTransport::send_parts(const struct iovec* parts, int count)
+{
+    for (int i = 0; i < count; ++i)
+        bytes_sent += parts[i].iov_len;
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef SESSION_RECORD_H_INCLUDED
+#define SESSION_RECORD_H_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <basic/configuration.h>
+#include <communication/transport.h>
+
+/* Recorded sessions ('--record <file>', '--replay <file>').
+ *
+ * File layout, all values little-endian:
+ *   header:  "SIMLOIDR", uint32 version, int32 robot, int32 scene,
+ *            int32 steps per control, uint32 flags, float64 step length
+ *   records: uint64 ns since recording started, uint32 length, length bytes
+ *
+ * A record holds the bytes of one read from the client, a record of length 0
+ * marks a disconnect. The header keeps the settings the replay depends on. */
+namespace session_record {
+    const char     magic[8] = {'S','I','M','L','O','I','D','R'};
+    const uint32_t version  = 1;
+
+    const std::size_t header_size        = 8 + 5 * 4 + 8;
+    const std::size_t record_header_size = 8 + 4;
+
+    /* flags */
+    const uint32_t pipelined_mode    = 1u << 0;
+    const uint32_t persistent_server = 1u << 1;
+    const uint32_t initial_gravity   = 1u << 2;
+}
+
+class SessionRecorder : public StreamSink {
+public:
+    SessionRecorder() : file(nullptr), start(), buf() {}
+    ~SessionRecorder() { if (file) fclose(file); }
+
+    bool open(std::string const& filename, Configuration const& conf);
+    void record(const char* data, std::size_t length); // length 0: client disconnected
+
+private:
+    FILE* file;
+    std::chrono::steady_clock::time_point start;
+    std::string buf;
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+};
+
+/* Plays a recorded session to the controller as fast as possible, in the
+ * chunks in which it was received. Replies are counted and dropped. With a
+ * persistent server the clients of the recording follow each other. */
+class ReplayTransport : public Transport {
+public:
+    ReplayTransport() : data(), pos(0), chunk_left(0), bytes_sent(0), bytes_received(0), recorded_ns(0) {}
+
+    bool load(std::string const& filename);  // read the whole file and check the header
+    void apply_settings(Configuration& conf) const;
+
+    bool establish_connection(void) { return not data.empty(); }
+    bool send_message(const std::string& msg) { bytes_sent += msg.size(); return true; }
+    bool send_parts(const struct iovec* parts, int count);
+
+    uint64_t sent(void) const { return bytes_sent; }
+    uint64_t received(void) const { return bytes_received; }
+    double   recorded_seconds(void) const { return recorded_ns * 1e-9; } // first to last record
+
+private:
+    std::size_t receive(char* dest, std::size_t max);
+    bool accept_client(void) { return pos < data.size(); }
+
+    std::vector<char> data;
+    std::size_t pos;        // next unread byte of data
+    std::size_t chunk_left; // bytes left of the current record
+    uint64_t    bytes_sent;
+    uint64_t    bytes_received;
+    uint64_t    recorded_ns;
+};
+
+#endif // SESSION_RECORD_H_INCLUDED
@@ -0,0 +1,207 @@
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <ode/ode.h>
+#include <communication/sessionserver.h>
+
+namespace {
+    const int max_events      = 64;
+    const int wait_timeout_ms = 100; // check for shutdown requests
+}
+
+SessionServer::SessionServer(Configuration const& conf, SocketServer* listener, unsigned int num_threads)
+: config(conf)
+, listener(listener)
+, num_threads(num_threads)
+, epollfd(-1)
+, session_counter(0)
+, mtx()
+, clients()
+, pool(nullptr)
+{
+    dInitODE(); // once for all sessions and their batch instances, worlds are created concurrently
+}
+
+SessionServer::~SessionServer()
+{
+    shutdown_clients();
+    delete pool;
+    for (Client* c : clients) {
+        delete c->session;
+        delete c;
+    }
+    if (-1 != epollfd) close(epollfd);
+    delete listener;
+    dCloseODE();
+}
+
+bool
+SessionServer::run(bool const& keep_running)
+{
+    printf("Session server: listening with %u worker threads...\n", num_threads);
+    fflush(stdout);
+
+    if (not listener->open_listener())
+        return false;
+
+    const int listenfd = listener->get_listener_fd();
+    fcntl(listenfd, F_SETFL, fcntl(listenfd, F_GETFL, 0) | O_NONBLOCK);
+
+    epollfd = epoll_create1(0);
+    if (-1 == epollfd) {
+        printf("ERROR creating epoll instance: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr; // marks the listener
+    if (-1 == epoll_ctl(epollfd, EPOLL_CTL_ADD, listenfd, &ev)) {
+        printf("ERROR adding listener to epoll: %s\n", strerror(errno));
+        return false;
+    }
+
+    /* each worker steps worlds of different sessions, so it needs ODE's per-thread data,
+       which is released automatically when the thread exits */
+    pool = new ThreadPool(num_threads, []() {
+        dAllocateODEDataForThread(dAllocateMaskAll);
+        dsErrorEndsSession = true;
+    });
+
+    struct epoll_event events[max_events];
+    while (keep_running)
+    {
+        const int n = epoll_wait(epollfd, events, max_events, wait_timeout_ms);
+        if (n < 0) {
+            if (EINTR == errno) continue;
+            printf("ERROR waiting for events: %s\n", strerror(errno));
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (nullptr == events[i].data.ptr)
+                accept_clients();
+            else {
+                Client* client = static_cast<Client*>(events[i].data.ptr);
+                pool->submit([this, client]() { serve(client); });
+            }
+        }
+    }
+
+    printf("Session server: shutting down.\n");
+    shutdown_clients();
+    delete pool; // waits for running cycles
+    pool = nullptr;
+    return true;
+}
+
+void
+SessionServer::accept_clients(void)
+{
+    int fd;
+    dsErrorEndsSession = true; // building a model may fail
+    while ((fd = accept(listener->get_listener_fd(), NULL, NULL)) >= 0)
+    {
+        Client* client = new Client{fd, nullptr};
+        SocketConnection* connection = new SocketConnection(fd);
+        try {
+            std::lock_guard<std::mutex> lock(mtx);
+            client->session = new Session(config, connection, ++session_counter);
+            clients.insert(client);
+        }
+        catch (DsSessionError const& e) {
+            printf("Session %u: ERROR creating the world: %s\n", session_counter, e.what());
+            delete connection; // closes the socket
+            delete client;
+            continue;
+        }
+        printf("Session %u: client connected.\n", client->session->get_id());
+
+        if (not start(client))
+            continue;
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.ptr = client;
+        if (-1 == epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev)) {
+            printf("ERROR adding client to epoll: %s\n", strerror(errno));
+            close_client(client);
+        }
+    }
+    if (EAGAIN != errno and EWOULDBLOCK != errno)
+        printf("ERROR on accept: %s\n", strerror(errno));
+    dsErrorEndsSession = false;
+}
+
+bool
+SessionServer::start(Client* client)
+{
+    try {
+        if (client->session->start())
+            return true;
+    }
+    catch (DsSessionError const& e) {
+        printf("Session %u: ERROR: %s\n", client->session->get_id(), e.what());
+    }
+    close_client(client);
+    return false;
+}
+
+void
+SessionServer::serve(Client* client)
+{
+    bool alive = false;
+    try {
+        alive = client->session->cycle();
+    }
+    catch (DsSessionError const& e) { // only this session fails, e.g. a bad model
+        printf("Session %u: ERROR: %s\n", client->session->get_id(), e.what());
+    }
+    if (not alive) {
+        close_client(client);
+        return;
+    }
+
+    /* commands which were already received are not signaled by epoll again */
+    if (client->session->has_pending_input())
+        pool->submit([this, client]() { serve(client); });
+    else
+        rearm(client);
+}
+
+void
+SessionServer::rearm(Client* client)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    ev.data.ptr = client;
+    if (-1 == epoll_ctl(epollfd, EPOLL_CTL_MOD, client->fd, &ev)) {
+        printf("ERROR re-arming client: %s\n", strerror(errno));
+        close_client(client);
+    }
+}
+
+void
+SessionServer::close_client(Client* client)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    clients.erase(client);
+    delete client->session; // closes the connection, which removes it from epoll
+    delete client;
+}
+
+void
+SessionServer::shutdown_clients(void)
+{
+    /* wake up workers blocked in reading, the sessions will receive 'EXIT' */
+    std::lock_guard<std::mutex> lock(mtx);
+    for (Client* c : clients)
+        shutdown(c->fd, SHUT_RDWR);
+}
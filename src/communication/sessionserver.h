@@ -0,0 +1,50 @@
+#ifndef SESSIONSERVER_H_INCLUDED
+#define SESSIONSERVER_H_INCLUDED
+
+#include <mutex>
+#include <set>
+
+#include <basic/configuration.h>
+#include <basic/thread_pool.h>
+#include <communication/socketserver.h>
+#include <controller/session.h>
+
+/* Multi-session server: accepts any number of clients on one listening socket
+ * and gives each of them its own Session (world, robot, controller).
+ * The acceptor waits with epoll for incoming control messages and hands the
+ * session to a worker pool, which runs one control cycle and re-arms it. */
+class SessionServer {
+public:
+    SessionServer(Configuration const& conf, SocketServer* listener, unsigned int num_threads);
+    ~SessionServer();
+
+    bool run(bool const& keep_running); // serve clients until keep_running is false
+
+private:
+    struct Client {
+        int      fd;
+        Session* session;
+    };
+
+    void accept_clients(void);
+    bool start(Client* client);           // false if the session failed and was closed
+    void serve(Client* client);           // called by worker threads
+    void rearm(Client* client);
+    void close_client(Client* client);
+    void shutdown_clients(void);
+
+    Configuration const& config;
+    SocketServer*        listener;
+    unsigned int         num_threads;
+    int                  epollfd;
+    unsigned int         session_counter;
+
+    std::mutex           mtx;     // guards clients
+    std::set<Client*>    clients;
+    ThreadPool*          pool;
+
+    SessionServer(const SessionServer&) = delete;
+    SessionServer& operator=(const SessionServer&) = delete;
+};
+
+#endif // SESSIONSERVER_H_INCLUDED
@@ -0,0 +1,42 @@
+#ifndef SHM_LAYOUT_H_INCLUDED
+#define SHM_LAYOUT_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+
+/* Memory layout of the shared-memory transport (POSIX shm object '/<name>').
+ *
+ * Each direction is a single-slot mailbox carrying chunks of the same byte
+ * stream as the TCP connection (text lines or binary frames). The writer waits
+ * until the previous chunk is acknowledged (ack == seq), copies the data, sets
+ * the length and increments seq. The reader waits for seq to change, consumes
+ * the data and sets ack = seq. Waiting is done with futexes on seq and ack.
+ */
+namespace shm_layout {
+
+    const uint32_t magic    = 0x53494d4c; // "LMIS"
+    const uint32_t version  = 1;
+    const uint32_t capacity = 1u << 20;   // bytes per mailbox, longer messages are sent in chunks
+
+    struct Mailbox {
+        std::atomic<uint32_t> seq;    // incremented by the writer for each chunk
+        std::atomic<uint32_t> ack;    // set to seq by the reader, when the chunk is consumed
+        uint32_t              length; // number of valid bytes in data
+        char                  data[capacity];
+    };
+
+    struct Region {
+        uint32_t              magic;
+        uint32_t              version;
+        std::atomic<uint32_t> connected;  // set to 1 by the client, reset to 0 on disconnect
+        std::atomic<int32_t>  client_pid; // to detect clients which died without disconnecting
+        Mailbox               status;     // simloid -> client
+        Mailbox               command;    // client -> simloid
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared memory transport needs lock-free atomics.");
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex words must be 32 bit.");
+
+} // namespace shm_layout
+
+#endif // SHM_LAYOUT_H_INCLUDED
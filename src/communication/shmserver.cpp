@@ -0,0 +1,216 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <communication/shmserver.h>
+
+namespace {
+
+    const unsigned int spin_iterations = 4096;      // busy waiting before going to sleep
+    const long         wait_timeout_ns = 100000000; // 100ms, wake up to check for dead clients
+
+    void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, long timeout_ns = wait_timeout_ns)
+    {
+        struct timespec timeout{0, timeout_ns};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+    }
+
+    void futex_wake(std::atomic<uint32_t>& word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    /* wait until word differs from old value, returns false if the client is gone */
+    template <typename AliveFn>
+    bool wait_for_change(std::atomic<uint32_t>& word, uint32_t old, AliveFn alive)
+    {
+        for (unsigned int i = 0; i < spin_iterations; ++i)
+            if (word.load(std::memory_order_acquire) != old)
+                return true;
+
+        while (word.load(std::memory_order_acquire) == old) {
+            if (not alive()) return false;
+            futex_wait(word, old);
+        }
+        return true;
+    }
+}
+
+SharedMemoryServer::SharedMemoryServer(std::string const& shm_name, bool const& keep_waiting)
+: name(shm_name)
+, region(nullptr)
+, chunk_offset(0)
+, keep_waiting(keep_waiting)
+{
+    if (name.empty() or name[0] != '/')
+        name = "/" + name;
+}
+
+SharedMemoryServer::~SharedMemoryServer() { close_region(); }
+
+bool
+SharedMemoryServer::establish_connection(void)
+{
+    printf("Shared memory transport: waiting for client on '%s'...\n", name.c_str());
+    fflush(stdout);
+
+    if (not open_region())
+        return false;
+
+    /* wait for client connection, a signal interrupts the futex wait */
+    while (region->connected.load(std::memory_order_acquire) == 0) {
+        if (not keep_waiting) {
+            printf("Stopped waiting for a shared memory client.\n");
+            close_region();
+            return false;
+        }
+        futex_wait(region->connected, 0);
+    }
+    return true;
+}
+
+bool
+SharedMemoryServer::open_region(void)
+{
+    shm_unlink(name.c_str()); // remove stale object of a previous run
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (-1 == fd) {
+        printf("ERROR opening shared memory '%s': %s\n", name.c_str(), strerror(errno));
+        return false;
+    }
+
+    if (-1 == ftruncate(fd, sizeof(shm_layout::Region))) {
+        printf("ERROR resizing shared memory: %s\n", strerror(errno));
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* addr = mmap(nullptr, sizeof(shm_layout::Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == addr) {
+        printf("ERROR mapping shared memory: %s\n", strerror(errno));
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    /* new object is zero-filled, magic is written last to mark it initialized */
+    region = static_cast<shm_layout::Region*>(addr);
+    region->version = shm_layout::version;
+    std::atomic_thread_fence(std::memory_order_release);
+    region->magic = shm_layout::magic;
+    return true;
+}
+
+void
+SharedMemoryServer::close_region(void)
+{
+    if (nullptr == region) return;
+
+    region->connected.store(0, std::memory_order_release);
+    futex_wake(region->status.seq);
+
+    munmap(region, sizeof(shm_layout::Region));
+    shm_unlink(name.c_str());
+    region = nullptr;
+    printf("Shared memory closed.\n");
+}
+
+bool
+SharedMemoryServer::client_alive(void) const
+{
+    if (region->connected.load(std::memory_order_acquire) == 0)
+        return false;
+
+    const pid_t pid = region->client_pid.load(std::memory_order_relaxed);
+    return (pid <= 0) or (kill(pid, 0) == 0) or (errno != ESRCH);
+}
+
+bool SharedMemoryServer::send_message(const std::string& msg)
+{
+    auto& box = region->status;
+    auto alive = [this]() { return client_alive(); };
+
+    std::size_t sent = 0;
+    do {
+        /* wait until the client consumed the last chunk */
+        const uint32_t seq = box.seq.load(std::memory_order_relaxed);
+        uint32_t ack;
+        while ((ack = box.ack.load(std::memory_order_acquire)) != seq)
+            if (not wait_for_change(box.ack, ack, alive)) {
+                printf("ERROR writing to shared memory, client is gone.\n");
+                return false;
+            }
+
+        const std::size_t length = std::min<std::size_t>(msg.size() - sent, shm_layout::capacity);
+        memcpy(box.data, msg.data() + sent, length);
+        box.length = length;
+        box.seq.store(seq + 1, std::memory_order_release);
+        futex_wake(box.seq);
+
+        sent += length;
+    } while (sent < msg.size());
+
+    return true;
+}
+
+bool SharedMemoryServer::input_ready(std::chrono::steady_clock::time_point deadline)
+{
+    auto& box = region->command;
+    if (chunk_offset > 0)
+        return true;
+
+    const uint32_t ack = box.ack.load(std::memory_order_relaxed);
+    while (box.seq.load(std::memory_order_acquire) == ack)
+    {
+        const long remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)
+            return false;
+        if (not client_alive())
+            return true; // the disconnect is reported by receive
+        futex_wait(box.seq, ack, std::min(remaining, wait_timeout_ns));
+    }
+    return true;
+}
+
+std::size_t SharedMemoryServer::receive(char* dest, std::size_t max)
+{
+    auto& box = region->command;
+
+    std::size_t n = 0;
+    while (0 == n)
+    {
+        if (0 == chunk_offset) {
+            const uint32_t ack = box.ack.load(std::memory_order_relaxed);
+            if (not wait_for_change(box.seq, ack, [this]() { return client_alive(); }))
+            {
+                printf("Client disconnected from shared memory. Exiting.\n");
+                return 0;
+            }
+        }
+
+        /* a chunk may be larger than the free space, it is acknowledged when fully read */
+        n = std::min<std::size_t>(box.length - chunk_offset, max);
+        memcpy(dest, box.data + chunk_offset, n);
+        chunk_offset += n;
+
+        if (chunk_offset >= box.length) {
+            chunk_offset = 0;
+            box.ack.store(box.seq.load(std::memory_order_acquire), std::memory_order_release);
+            futex_wake(box.ack);
+        }
+    }
+    return n;
+}
@@ -0,0 +1,33 @@
+#ifndef SHMSERVER_H_INCLUDED
+#define SHMSERVER_H_INCLUDED
+
+#include <string>
+
+#include <communication/transport.h>
+#include <communication/shm_layout.h>
+
+/* Transport for controllers running on the same host:
+ * status and commands are exchanged via a POSIX shared-memory object,
+ * see shm_layout.h for the protocol. */
+class SharedMemoryServer : public Transport
+{
+public:
+    SharedMemoryServer(std::string const& name, bool const& keep_waiting);
+    ~SharedMemoryServer();
+    bool establish_connection(void);
+    bool send_message(const std::string& msg);
+
+private:
+    std::string         name;   // name of the shm object, starting with '/'
+    shm_layout::Region* region;
+    std::size_t         chunk_offset; // bytes of the current command chunk already received
+    bool const&         keep_waiting; // for a client, reset by SIGINT and SIGTERM
+
+    bool open_region(void);
+    void close_region(void);
+    bool client_alive(void) const;
+    std::size_t receive(char* dest, std::size_t max);
+    bool input_ready(std::chrono::steady_clock::time_point deadline);
+};
+
+#endif // SHMSERVER_H_INCLUDED
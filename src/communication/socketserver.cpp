@@ -1,26 +1,161 @@
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <poll.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <algorithm>
 
 #include <communication/socketserver.h>
 
+namespace {
+
+    /* writes all bytes, send may return early on signals or a full socket buffer */
+    bool write_all(const int fd, const char* data, std::size_t length)
+    {
+        while (length > 0)
+        {
+            // MSG_NOSIGNAL: a vanished client must not kill the process with SIGPIPE
+            const ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (EINTR == errno) continue;
+                printf("ERROR writing to socket: %s\n", strerror(errno));
+                return false;
+            }
+            data   += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    bool write_socket(const int fd, const std::string& msg) { return write_all(fd, msg.data(), msg.size()); }
+
+    /* gathering write, sendmsg instead of writev for MSG_NOSIGNAL */
+    bool write_socket(const int fd, const struct iovec* parts, int count)
+    {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov    = const_cast<struct iovec*>(parts);
+        msg.msg_iovlen = count;
+
+        ssize_t n;
+        while ((n = sendmsg(fd, &msg, MSG_NOSIGNAL)) < 0 and EINTR == errno) {}
+        if (n < 0) {
+            printf("ERROR writing to socket: %s\n", strerror(errno));
+            return false;
+        }
+
+        /* partial write, e.g. a large frame: the rest part by part */
+        std::size_t sent = n;
+        for (int i = 0; i < count; ++i) {
+            const std::size_t skip = std::min(sent, parts[i].iov_len);
+            sent -= skip;
+            if (not write_all(fd, static_cast<const char*>(parts[i].iov_base) + skip, parts[i].iov_len - skip))
+                return false;
+        }
+        return true;
+    }
+
+    std::size_t read_socket(const int fd, char* dest, std::size_t max)
+    {
+        // read from socket (blocking)
+        ssize_t n;
+        while ((n = recv(fd, dest, max, 0)) < 0 and EINTR == errno) {}
+
+        if (n < 0)
+        {
+            printf("ERROR reading from socket: %s\n", strerror(errno));
+            return 0; // treated as disconnect
+        }
+
+        if (0 == n)
+            printf("Reading no more bytes from socket. Exiting.\n");
+
+        return n;
+    }
+
+    /* false if nothing arrived until the deadline, errors and hangups are reported by the next read */
+    bool wait_readable(const int fd, std::chrono::steady_clock::time_point deadline)
+    {
+        using namespace std::chrono;
+        struct pollfd pfd{fd, POLLIN, 0};
+        int r;
+        do {
+            const auto remaining = std::max(deadline - steady_clock::now(), steady_clock::duration::zero());
+            const auto sec       = duration_cast<seconds>(remaining);
+            const struct timespec timeout{sec.count(), duration_cast<nanoseconds>(remaining - sec).count()};
+            r = ppoll(&pfd, 1, &timeout, nullptr);
+        } while (r < 0 and EINTR == errno);
+        return r != 0;
+    }
+}
+
 SocketServer::SocketServer(const int port)
-: sockfd(-1), connectfd(-1), portno(port), receivedStream("")
+: sockfd(-1), connectfd(-1), portno(port), socket_path()
+{ }
+
+SocketServer::SocketServer(const std::string& path)
+: sockfd(-1), connectfd(-1), portno(0), socket_path(path)
 { }
 
 SocketServer::~SocketServer() { close_connection(); }
 
 bool
-SocketServer::establish_connection(void) { return open_connection(); }
+SocketServer::establish_connection(void)
+{
+    if (socket_path.empty())
+        printf("TCP Controller: listening to port %d...\n", portno);
+    else
+        printf("TCP Controller: listening to socket '%s'...\n", socket_path.c_str());
+    fflush(stdout);
+    return open_connection();
+}
+
+bool
+SocketServer::open_listener(void)
+{
+    if (not (socket_path.empty() ? bind_tcp() : bind_unix()))
+        return false;
+
+    // listen (to max. SOMAXCONN processes in the queue)
+    if (-1 == listen(sockfd, SOMAXCONN))
+    {
+        printf("ERROR listening.\n");
+        close(sockfd);
+        sockfd = -1;
+        return false;
+    }
+    return true;
+}
 
 bool
 SocketServer::open_connection(void)
+{
+    if (not open_listener())
+        return false;
+
+    // wait for client connection, SIGUSR1 restarts accept, SIGINT and SIGTERM end the wait
+    connectfd = accept(sockfd, NULL, NULL);
+
+    if (0 > connectfd)
+    {
+        printf("ERROR on accept.\n");
+        close(sockfd);
+        return false;
+    }
+
+    // connection established
+    return true;
+}
+
+bool
+SocketServer::bind_tcp(void)
 {
     // create socket
     // Domain: AF_INIT (Address for heterogeneous systems)
@@ -56,26 +191,42 @@ SocketServer::open_connection(void)
         close(sockfd);
         return false;
     }
+    return true;
+}
+
+bool
+SocketServer::bind_unix(void)
+{
+    // Domain: AF_UNIX (local stream socket, no TCP stack and no port needed)
+    sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
 
-    // listen (to max. 5 processes in the queue)
-    if (-1 == listen(sockfd, 5))
+    if (-1 == sockfd)
     {
-        printf("ERROR listening.\n");
-        close(sockfd);
+        printf("ERROR opening socket\n");
         return false;
     }
 
-    // wait for client connection
-    connectfd = accept(sockfd, NULL, NULL);
+    struct sockaddr_un unix_addr;
+    memset((char *) &unix_addr, 0, sizeof(unix_addr));
+    unix_addr.sun_family = AF_UNIX;
 
-    if (0 > connectfd)
+    if (socket_path.size() >= sizeof(unix_addr.sun_path))
     {
-        printf("ERROR on accept.\n");
+        printf("ERROR socket path too long: '%s'\n", socket_path.c_str());
         close(sockfd);
         return false;
     }
+    strncpy(unix_addr.sun_path, socket_path.c_str(), sizeof(unix_addr.sun_path) - 1);
 
-    // connection established
+    // remove stale socket file of a previous run
+    unlink(socket_path.c_str());
+
+    if (-1 == bind(sockfd, (struct sockaddr *) &unix_addr, sizeof(unix_addr)))
+    {
+        printf("ERROR on binding socket '%s'.\n", socket_path.c_str());
+        close(sockfd);
+        return false;
+    }
     return true;
 }
 
@@ -95,53 +246,54 @@ SocketServer::close_connection(void)
         close(connectfd);
     }
     close(sockfd);
+    if (not socket_path.empty())
+        unlink(socket_path.c_str());
     printf("Socket closed.\n");
 }
 
-bool SocketServer::send_message(const std::string& msg) const
-{
-    int n = write(connectfd, msg.c_str(), msg.length());
-    if (n < 0) {
-        printf("ERROR writing to socket.\n");
-        return false;
-    }
-    return true;
-}
+bool SocketServer::send_message(const std::string& msg) { return write_socket(connectfd, msg); }
 
-std::string SocketServer::getNextMessage() const
-{
-    #define MSGLEN 8192
-    char buffer[MSGLEN];
-    memset(buffer, 0, MSGLEN); // clear buffer
+bool SocketServer::send_parts(const struct iovec* parts, int count) { return write_socket(connectfd, parts, count); }
+
+std::size_t SocketServer::receive(char* dest, std::size_t max) { return read_socket(connectfd, dest, max); }
 
-    // read from socket (blocking)
-    int n = read(connectfd, buffer, MSGLEN); // TODO: make non-blocking read
-    if (n < 0)
+bool SocketServer::input_ready(std::chrono::steady_clock::time_point deadline) { return wait_readable(connectfd, deadline); }
+
+bool
+SocketServer::accept_client(void)
+{
+    // close the connection of the previous client, keep listening
+    if (-1 != connectfd)
     {
-        printf("ERROR reading from socket\n");
-        return std::string("");
+        shutdown(connectfd, SHUT_RDWR);
+        close(connectfd);
+        connectfd = -1;
     }
 
-    if (0 == n)
+    printf("TCP Controller: waiting for the next client...\n");
+    fflush(stdout);
+
+    // blocks until a client connects, SIGINT or SIGTERM interrupts it (SIGUSR1 restarts, see signals.h)
+    connectfd = accept(sockfd, NULL, NULL);
+    if (0 > connectfd)
     {
-        printf("Reading no more bytes from socket. Exiting.\n");
-        return std::string("EXIT\n");
+        printf("ERROR on accept: %s\n", strerror(errno));
+        return false;
     }
-
-    return std::string(buffer);
+    return true;
 }
 
-std::string SocketServer::getNextLine(void)
+
+SocketConnection::~SocketConnection()
 {
-    std::string::size_type pos;
-    std::string ret;
+    shutdown(connectfd, SHUT_RDWR);
+    close(connectfd);
+}
 
-    while((pos = receivedStream.find("\n", 0)) == std::string::npos)
-    {
-        receivedStream += getNextMessage();
-    }
-    ret = receivedStream.substr(0, pos);
-    receivedStream.erase(0, pos+1);
+bool SocketConnection::send_message(const std::string& msg) { return write_socket(connectfd, msg); }
 
-    return ret;
-}
+bool SocketConnection::send_parts(const struct iovec* parts, int count) { return write_socket(connectfd, parts, count); }
+
+std::size_t SocketConnection::receive(char* dest, std::size_t max) { return read_socket(connectfd, dest, max); }
+
+bool SocketConnection::input_ready(std::chrono::steady_clock::time_point deadline) { return wait_readable(connectfd, deadline); }
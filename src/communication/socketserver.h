@@ -4,24 +4,50 @@
 #include <netinet/in.h>
 #include <string>
 
-class SocketServer
+#include <communication/transport.h>
+
+class SocketServer : public Transport
 {
 public:
     SocketServer(const int port);
+    SocketServer(const std::string& path); // unix domain socket
     ~SocketServer();
     bool establish_connection(void);
-    bool send_message(const std::string& msg) const;
-    std::string getNextLine(); // get message stream until \n
+    bool send_message(const std::string& msg);
+    bool send_parts(const struct iovec* parts, int count);
+
+    bool open_listener(void);              // bind and listen without accepting a client
+    int  get_listener_fd(void) const { return sockfd; }
 
 private:
     int sockfd, connectfd;    // socket file descriptors
     int portno;               // port number
+    std::string socket_path;  // path of unix domain socket, empty for TCP
     struct sockaddr_in serv_addr;
-    std::string receivedStream;
 
     bool open_connection(void);
+    bool bind_tcp(void);
+    bool bind_unix(void);
     void close_connection(void);
-    std::string getNextMessage() const;
+    std::size_t receive(char* dest, std::size_t max);
+    bool accept_client(void);
+    bool input_ready(std::chrono::steady_clock::time_point deadline);
+};
+
+/* connection to a client which was accepted elsewhere, e.g. by the SessionServer */
+class SocketConnection : public Transport
+{
+public:
+    SocketConnection(const int fd) : connectfd(fd) {}
+    ~SocketConnection();
+    bool establish_connection(void) { return true; }
+    bool send_message(const std::string& msg);
+    bool send_parts(const struct iovec* parts, int count);
+
+private:
+    int connectfd;
+    std::size_t receive(char* dest, std::size_t max);
+    bool input_ready(std::chrono::steady_clock::time_point deadline);
 };
 
 #endif /* _SOCKETSERVER_H_ */
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <communication/status_compression.h>
+
+void StatusCompression::enable(const double res, const unsigned int interval)
+{
+    resolution = res;
+    keyframe_interval = std::max(1u, interval);
+    request_keyframe();
+}
+
+int32_t StatusCompression::quantize(const double value) const
+{
+    const double q = std::round(value / resolution);
+    if (std::isnan(q)) return 0;
+
+    /* saturate values beyond the range of the resolution */
+    if (q >= std::numeric_limits<int32_t>::max()) return std::numeric_limits<int32_t>::max();
+    if (q <= std::numeric_limits<int32_t>::min()) return std::numeric_limits<int32_t>::min();
+    return static_cast<int32_t>(q);
+}
+
+void StatusCompression::encode(std::vector<double> const& values, StatusWriter& writer)
+{
+    current.resize(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+        current[i] = quantize(values[i]);
+
+    bool keyframe = (previous.size() != current.size()) or (++frames_since_keyframe >= keyframe_interval);
+
+    deltas.resize(current.size());
+    for (std::size_t i = 0; i < current.size() and not keyframe; ++i)
+    {
+        const int64_t d = int64_t(current[i]) - int64_t(previous[i]);
+        if (d > std::numeric_limits<int16_t>::max() or d < std::numeric_limits<int16_t>::min())
+            keyframe = true;
+        else
+            deltas[i] = static_cast<int16_t>(d);
+    }
+
+    if (keyframe) {
+        writer.start(true, binary_protocol::keyframe);
+        writer.append(current.data(), current.size());
+        frames_since_keyframe = 0;
+    } else {
+        writer.start(true, binary_protocol::delta);
+        writer.append(deltas.data(), deltas.size());
+    }
+    previous.swap(current);
+}
@@ -0,0 +1,41 @@
+#ifndef STATUS_COMPRESSION_H_INCLUDED
+#define STATUS_COMPRESSION_H_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include <communication/status_writer.h>
+
+/* Compressed status stream of the binary protocol, enabled with 'COMPRESSION'.
+ * Each value is quantized to the negotiated resolution, q = round(value / resolution).
+ * A keyframe ("KEYF") carries all q as int32, the following frames ("DELT")
+ * carry the int16 differences to the q of the previous frame. A keyframe is
+ * sent periodically, when a difference does not fit into int16 and when the
+ * layout of the status message changes. */
+class StatusCompression {
+public:
+    StatusCompression() : resolution(0.0), keyframe_interval(0), frames_since_keyframe(0), previous(), current(), deltas() {}
+
+    void enable(const double res, const unsigned int interval);
+    void disable(void) { resolution = 0.0; }
+    bool enabled(void) const { return resolution > 0.0; }
+
+    void request_keyframe(void) { previous.clear(); } // status layout has changed
+
+    void encode(std::vector<double> const& values, StatusWriter& writer);
+
+    static const unsigned int default_keyframe_interval = 100;
+
+private:
+    int32_t quantize(const double value) const;
+
+    double       resolution;            // value of one quantization step, 0 = disabled
+    unsigned int keyframe_interval;     // frames between keyframes
+    unsigned int frames_since_keyframe;
+
+    std::vector<int32_t> previous;      // quantized values of the last frame, as known by the client
+    std::vector<int32_t> current;
+    std::vector<int16_t> deltas;
+};
+
+#endif // STATUS_COMPRESSION_H_INCLUDED
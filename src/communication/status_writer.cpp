@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <communication/status_writer.h>
+
+namespace {
+    /* little-endian copy of count values */
+    template <typename T>
+    void put_binary(char* out, const T* values, std::size_t count)
+    {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        memcpy(out, values, count * sizeof(T));
+#else
+        for (std::size_t i = 0; i < count; ++i) {
+            typedef typename std::conditional<sizeof(T) == 8, uint64_t,
+                    typename std::conditional<sizeof(T) == 4, uint32_t, uint16_t>::type>::type Bits;
+            Bits v;
+            memcpy(&v, &values[i], sizeof(T));
+            for (unsigned b = 0; b < sizeof(T); ++b) out[sizeof(T)*i + b] = static_cast<char>((v >> (8*b)) & 0xff);
+        }
+#endif
+    }
+}
+
+void StatusWriter::reserve(std::size_t num_values)
+{
+    const std::size_t capacity = num_values * text_width + max_text_width;
+    if (buffer.size() < capacity)
+        buffer.resize(capacity);
+}
+
+void StatusWriter::start(const bool binary_mode, const binary_protocol::FrameType frame_type)
+{
+    length = 0;
+    binary = binary_mode;
+    type   = frame_type;
+}
+
+void StatusWriter::append(const double* values, std::size_t count)
+{
+    if (binary)
+    {
+        ensure(count * sizeof(double));
+        put_binary(buffer.data() + length, values, count);
+        length += count * sizeof(double);
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (buffer.size() - length < max_text_width)
+            ensure(max_text_width);
+
+        char* first = buffer.data() + length;
+        char* last  = buffer.data() + buffer.size() - 1; // keep space for the blank
+        const auto result = std::to_chars(first, last, values[i], std::chars_format::fixed, 6);
+        *result.ptr = ' ';
+        length = result.ptr + 1 - buffer.data();
+    }
+}
+
+void StatusWriter::append(const int32_t* values, std::size_t count)
+{
+    assert(binary);
+    ensure(count * sizeof(int32_t));
+    put_binary(buffer.data() + length, values, count);
+    length += count * sizeof(int32_t);
+}
+
+void StatusWriter::append(const int16_t* values, std::size_t count)
+{
+    assert(binary);
+    ensure(count * sizeof(int16_t));
+    put_binary(buffer.data() + length, values, count);
+    length += count * sizeof(int16_t);
+}
+
+void StatusWriter::end_record(void)
+{
+    if (binary) return;
+    ensure(1);
+    buffer[length++] = '\n';
+}
+
+bool StatusWriter::send(Transport& connection)
+{
+    struct iovec parts[2];
+    int count = 0;
+
+    if (binary) {
+        const uint32_t payload = length;
+        for (unsigned i = 0; i < 4; ++i) {
+            header[i]     = static_cast<char>((payload >> (8*i)) & 0xff);
+            header[4 + i] = static_cast<char>((type    >> (8*i)) & 0xff);
+        }
+        parts[count++] = { header, sizeof(header) };
+    }
+    parts[count++] = { buffer.data(), length };
+
+    return connection.send_parts(parts, count);
+}
+
+void StatusWriter::ensure(std::size_t extra)
+{
+    if (buffer.size() < length + extra)
+        buffer.resize(std::max(2 * buffer.size(), length + extra));
+}
@@ -0,0 +1,47 @@
+#ifndef STATUS_WRITER_H_INCLUDED
+#define STATUS_WRITER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <communication/binary_protocol.h>
+#include <communication/transport.h>
+
+/* Reusable output buffer for status messages. It is sized once from the
+ * robot's traits and formats the values in place, text with the fixed
+ * precision of "%lf " or binary as little-endian float64. A message may
+ * hold several records (rollout) and is sent with one gathering write. */
+class StatusWriter {
+public:
+    StatusWriter() : buffer(), length(0), binary(false), type(binary_protocol::status) {}
+
+    void reserve(std::size_t num_values); // capacity for a message of num_values
+
+    void start(const bool binary_mode, const binary_protocol::FrameType frame_type = binary_protocol::status);
+    void append(const double* values, std::size_t count);
+    void append(std::vector<double> const& values) { append(values.data(), values.size()); }
+    void append(const int32_t* values, std::size_t count); // binary only
+    void append(const int16_t* values, std::size_t count); // binary only
+    void end_record(void); // line break between records of a text message
+
+    const char* data(void) const { return buffer.data(); }
+    std::size_t size(void) const { return length; }
+
+    bool send(Transport& connection);
+
+    /* longest "%lf " of a double: sign, 309 integer digits, point, 6 decimals, blank */
+    static const std::size_t max_text_width = 1 + 309 + 1 + 6 + 1;
+    static const std::size_t text_width     = 12; // typical width, e.g. "-0.123456 "
+
+private:
+    void ensure(std::size_t extra);
+
+    std::vector<char> buffer;
+    std::size_t       length;
+    bool              binary;
+    binary_protocol::FrameType type;
+    char              header[binary_protocol::frame_header_size];
+};
+
+#endif // STATUS_WRITER_H_INCLUDED
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cstring>
+
+#include <communication/transport.h>
+
+std::string_view Transport::getNextLine(void)
+{
+    char* end;
+    while (nullptr == (end = static_cast<char*>(memchr(&buffer[scan], '\n', tail - scan))))
+    {
+        scan = tail;
+        fill();
+    }
+    *end = '\0'; // the parsers expect C strings
+
+    const std::string_view line(&buffer[head], end - &buffer[head]);
+    head = scan = end - buffer.data() + 1;
+    return line;
+}
+
+char Transport::peek_byte(void)
+{
+    while (head == tail)
+        fill();
+
+    return buffer[head];
+}
+
+bool Transport::get_bytes(std::size_t num, std::string_view& bytes)
+{
+    while (tail - head < num)
+        if (not fill())
+            return false; // the partial frame is dropped, "EXIT\n" follows
+
+    bytes = std::string_view(&buffer[head], num);
+    head += num;
+    scan = std::max(scan, head);
+    return true;
+}
+
+bool Transport::wait_for_input(std::chrono::steady_clock::time_point deadline)
+{
+    if (head != tail)
+        return true;
+    if (not input_ready(deadline))
+        return false;
+
+    fill();
+    return true;
+}
+
+bool Transport::next_client(void)
+{
+    head = scan = tail = 0;
+    return accept_client();
+}
+
+bool Transport::fill(void)
+{
+    if (head == tail)
+        head = scan = tail = 0;
+
+    if (buffer.size() - tail < min_receive)
+    {
+        /* drop consumed bytes, the rest is less than one message */
+        memmove(buffer.data(), &buffer[head], tail - head);
+        tail -= head;
+        scan -= head;
+        head  = 0;
+
+        /* a line longer than the buffer */
+        if (buffer.size() - tail < min_receive)
+            buffer.resize(2 * buffer.size());
+    }
+
+    const std::size_t n = receive(&buffer[tail], buffer.size() - tail);
+    received_at = std::chrono::steady_clock::now();
+    if (recorder) recorder->record(&buffer[tail], n);
+    if (n > 0) {
+        tail += n;
+        return true;
+    }
+
+    /* client is gone, let the controller end the session. The unread bytes
+     * are an incomplete line or frame, the command starts a line of its own. */
+    static const char exit_command[] = "EXIT\n";
+    tail = scan = head;
+    memcpy(&buffer[tail], exit_command, sizeof(exit_command) - 1);
+    tail += sizeof(exit_command) - 1;
+    return false;
+}
+
+/* default: gather the parts and send them as one message */
+bool Transport::send_parts(const struct iovec* parts, int count)
+{
+    gathered.clear();
+    for (int i = 0; i < count; ++i)
+        gathered.append(static_cast<const char*>(parts[i].iov_base), parts[i].iov_len);
+
+    return send_message(gathered);
+}
@@ -0,0 +1,65 @@
+#ifndef TRANSPORT_H_INCLUDED
+#define TRANSPORT_H_INCLUDED
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/uio.h>
+
+/* receives a copy of the incoming stream, e.g. to record the session */
+class StreamSink
+{
+public:
+    virtual ~StreamSink() {}
+    virtual void record(const char* data, std::size_t length) = 0; // length 0: client disconnected
+};
+
+/* Base class for the connection to the controlling client.
+ * Derived classes receive the byte stream into the free space of a
+ * buffer, line and byte framing is done here without copying: lines and
+ * frames are returned as views into the buffer, valid until the next read.
+ * Consumed bytes are dropped by moving the unread rest to the front, so a
+ * line is always contiguous. The buffer grows only for lines longer than
+ * its capacity. */
+class Transport
+{
+public:
+    Transport() : buffer(initial_capacity), head(0), scan(0), tail(0), gathered(), received_at(), recorder(nullptr) {}
+    virtual ~Transport() {}
+
+    virtual bool establish_connection(void) = 0;
+    virtual bool send_message(const std::string& msg) = 0;
+    virtual bool send_parts(const struct iovec* parts, int count); // one message from several buffers
+
+    std::string_view getNextLine();              // next line without '\n', null-terminated, "EXIT" if disconnected
+    char             peek_byte();                // next byte of the stream, without consuming it
+    bool get_bytes(std::size_t num, std::string_view& bytes); // exactly num bytes of the stream, false if the client left before
+    bool has_buffered_data(void) const { return head != tail; }
+    bool wait_for_input(std::chrono::steady_clock::time_point deadline); // false if no byte arrived until deadline
+    std::chrono::steady_clock::time_point last_receive(void) const { return received_at; } // arrival of the latest bytes
+
+    bool next_client(void); // drop the rest of the stream and wait for the next client (persistent server)
+    void record_to(StreamSink* r) { recorder = r; } // pass the received stream to r, e.g. a session record, not owned
+
+    static const std::size_t initial_capacity = 1 << 16;
+    static const std::size_t min_receive      = 1 << 12; // free space for one read
+
+protected:
+    virtual std::size_t receive(char* dest, std::size_t max) = 0; // read up to max bytes (blocking), 0 if disconnected
+    virtual bool accept_client(void) { return false; }            // replace the connection, if supported
+    virtual bool input_ready(std::chrono::steady_clock::time_point) { return true; } // wait until receive would not block, false at deadline
+
+private:
+    bool fill(void); // make room and receive more bytes, false if the client is gone
+
+    std::vector<char> buffer;
+    std::size_t head;           // first unread byte
+    std::size_t scan;           // bytes before are known to contain no '\n'
+    std::size_t tail;           // end of received bytes
+    std::string gathered;       // reused by the default send_parts
+    std::chrono::steady_clock::time_point received_at;
+    StreamSink* recorder;
+};
+
+#endif // TRANSPORT_H_INCLUDED
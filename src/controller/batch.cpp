@@ -0,0 +1,45 @@
+#include <cmath>
+
+#include <controller/batch.h>
+#include <build/bioloid.h>
+
+BatchInstance::BatchInstance(Configuration const& conf, int model_id, std::vector<double> const& model_params)
+: universe(conf)
+, robot(universe.world, universe.space, conf)
+, obstacles(universe.world, universe.space, universe.static_space)
+, landscape(universe.static_space)
+, initial()
+, time(0.0)
+{
+    Bioloid::create_robot(robot, model_id, model_params);
+    Bioloid::create_scene(obstacles, landscape, conf.scene);
+    universe.fit_space(conf);
+    recordSnapshot(robot, obstacles, &initial);
+}
+
+void BatchInstance::step(const unsigned int num_steps, const double step_length)
+{
+    for (unsigned int i = 0; i < num_steps; ++i) {
+        robot.joints.apply_control_all();
+        universe.step(step_length);
+        time += step_length;
+    }
+}
+
+void BatchInstance::reset(void)
+{
+    playSnapshot(robot, obstacles, &initial);
+    robot.joints.reset_all();
+    robot.accels.reset_all();
+    time = 0.0;
+}
+
+bool has_diverged(Robot const& robot)
+{
+    for (std::size_t i = 0; i < robot.number_of_bodies(); ++i) {
+        const Vector3 pos = robot.bodies[i].get_position();
+        if (not (std::isfinite(pos.x) and std::isfinite(pos.y) and std::isfinite(pos.z)))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,41 @@
+#ifndef BATCH_H_INCLUDED
+#define BATCH_H_INCLUDED
+
+#include <vector>
+
+#include <basic/snapshot.h>
+#include <build/physics.h>
+#include <build/robot.h>
+#include <build/obstacles.h>
+#include <build/heightfield.h>
+
+/* An additional, independent world of a batch (vectorized environment).
+ * It is built from the same model as the controller's robot and steps
+ * with the control signals set by the controller. */
+class BatchInstance {
+public:
+    BatchInstance(Configuration const& conf, int model_id, std::vector<double> const& model_params);
+
+    void step(const unsigned int num_steps, const double step_length); // apply controls and step the world
+    void reset(void);                                                  // restore initial state
+    void set_solver(Configuration const& conf) { universe.set_solver(conf); }
+    void set_gravity(bool enable) { universe.set_gravity(enable); }
+    void toggle_fixed(unsigned int idx) { robot.bodies[idx].toggle_fixed(universe.world); }
+
+    Robot&       get_robot(void)       { return robot; }
+    double       get_time (void) const { return time;  }
+
+private:
+    physics   universe;
+    Robot     robot;
+    Obstacle  obstacles;
+    Landscape landscape;
+
+    Snapshot  initial;
+    double    time;
+};
+
+/* true if any body of the robot has left the valid (finite) state space */
+bool has_diverged(Robot const& robot);
+
+#endif // BATCH_H_INCLUDED
@@ -1,6 +1,7 @@
 #ifndef _CONTROLLER_H_
 #define _CONTROLLER_H_
 
+#include <functional>
 #include <ode/ode.h>
 #include <basic/common.h>
 #include <build/robot.h>
@@ -10,26 +11,31 @@
 class Controller
 {
 public:
-    Controller(physics const& universe, Robot& robot, Obstacle& obstacles, Landscape& landscape, void (*_resetTime)())
+    Controller( physics& universe, Robot& robot, Obstacle& obstacles, Landscape& landscape
+              , std::function<void(double)> _setTime, std::function<void()> _physicsStep )
     : universe(universe)
     , robot(robot)
     , obstacles(obstacles)
     , landscape(landscape)
-    , reset_time(_resetTime)
+    , set_time(_setTime)
+    , physics_step(_physicsStep)
+    , paused(false)
     {}
     virtual ~Controller() {}
     virtual bool control(const double time) = 0;
     virtual void reset() = 0;
+    virtual void print_statistics(void) const {}
 
     bool is_paused(void) const { return paused; }
 
 protected:
-    physics const& universe;
+    physics&       universe;
     Robot&         robot;
     Obstacle&      obstacles;
     Landscape&     landscape;
 
-    void (*reset_time)();
+    std::function<void(double)> set_time;
+    std::function<void()> physics_step;
     bool paused;
 };
 
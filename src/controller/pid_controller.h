@@ -21,6 +21,10 @@ public:
     double set_position(const double setpoint, const double current_angle);
     void reset();
 
+    static const std::size_t state_size = 2;
+    void get_state(double* s) const { s[0] = lastError; s[1] = iState; }
+    void set_state(const double* s) { lastError = s[0]; iState = s[1]; }
+
 protected:
     const double pGain; // proportional gain
     const double iGain; // integral gain
@@ -0,0 +1,62 @@
+#include <controller/session.h>
+#include <build/bioloid.h>
+
+Session::Session(Configuration const& conf, Transport* transport, unsigned int id)
+: id(id)
+, config(conf)
+, universe(config)
+, robot(universe.world, universe.space, config)
+, obstacles(universe.world, universe.space, universe.static_space)
+, landscape(universe.static_space)
+, camera()
+, simtime(0.0)
+, controller(nullptr)
+, transport(transport)
+{
+    dsPrint("Session %u: creating robot and scene.\n", id);
+    Bioloid::create_robot(robot, config.robot, std::vector<double>{});
+    Bioloid::create_scene(obstacles, landscape, config.scene);
+    universe.fit_space(config);
+
+    controller = new TCPController( config, universe, robot, obstacles, landscape
+                                  , [this](double t) { simtime = t; }
+                                  , [this]() { physics_step(); }
+                                  , camera );
+}
+
+Session::~Session()
+{
+    delete controller;
+    delete transport; // only if the session was never started
+    dsPrint("Session %u closed.\n", id);
+}
+
+bool Session::start(void)
+{
+    Transport* t = transport;
+    transport = nullptr;
+    if (not controller->establishConnection(t))
+        return false;
+
+    /* the single session main loop steps once before waiting for the client's 'ACK' */
+    physics_step();
+    return true;
+}
+
+bool Session::cycle(void)
+{
+    if (not controller->handle_commands(simtime))
+        return false;
+
+    if (not controller->is_paused())
+        physics_step();
+
+    controller->send_status(simtime);
+    return true;
+}
+
+void Session::physics_step(void)
+{
+    universe.step(config.step_length);
+    simtime += config.step_length;
+}
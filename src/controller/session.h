@@ -0,0 +1,48 @@
+#ifndef SESSION_H_INCLUDED
+#define SESSION_H_INCLUDED
+
+#include <basic/configuration.h>
+#include <build/physics.h>
+#include <build/robot.h>
+#include <build/obstacles.h>
+#include <build/heightfield.h>
+#include <controller/tcp_controller.h>
+#include <communication/transport.h>
+#include <misc/camera.h>
+
+/* One client of the multi-session server: an independent world with its own
+ * robot, scene and TCP controller. A session is only stepped by one thread at
+ * a time, but subsequent cycles may run on different threads. */
+class Session {
+public:
+    Session(Configuration const& conf, Transport* transport, unsigned int id);
+    ~Session();
+
+    bool start(void); // send robot configuration and do the first physics step
+    bool cycle(void); // receive one control message and advance the physics
+
+    bool has_pending_input(void) const { return controller->has_pending_input(); }
+    unsigned int get_id(void) const { return id; }
+
+private:
+    void physics_step(void);
+
+    const unsigned int id;
+    Configuration config; // own copy, is modified by the controller
+
+    physics   universe;
+    Robot     robot;
+    Obstacle  obstacles;
+    Landscape landscape;
+    Camera    camera;
+
+    double simtime;
+
+    TCPController* controller;
+    Transport*     transport; // owned by the controller after start()
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+};
+
+#endif // SESSION_H_INCLUDED
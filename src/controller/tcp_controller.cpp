@@ -1,11 +1,9 @@
 #include <controller/tcp_controller.h>
 
-bool TCPController::establishConnection(int port)
+bool TCPController::establishConnection(Transport* transport)
 {
-    dsPrint("TCP Controller: listening to port %d...\n", port);
-    fflush(stdout);
-    socketServer = new SocketServer(port);
-    if (socketServer->establish_connection())
+    connection = transport; // take ownership
+    if (connection->establish_connection())
     {
         dsPrint("Connection to client established.\nSending the robot's configuration to client.\n");
         TCPController::send_robot_configuration();
@@ -18,159 +16,386 @@ bool TCPController::establishConnection(int port)
     }
 }
 
-inline bool starts_with(std::string msg, const char c_str[])
+bool TCPController::control(const double time)
 {
-    return (msg.compare(0, strlen(c_str), c_str) == 0);
+    send_status(time);
+    if (handle_commands(time))
+        return true;
+
+    return config.persistent_server and start_next_session();
 }
 
-bool TCPController::control(const double time)
+/* persistent server: the client has gone, return to the state of a fresh
+   start and wait for the next client, the world is kept. */
+bool TCPController::start_next_session(void)
 {
-    bool done = false;
-    unsigned int fail_counter = 0;
-    std::string msg;
+    dsPrint("Client disconnected, resetting simulation.\n");
+    clear_batch();
+
+    if (model_changed) {
+        playSnapshot(robot, obstacles, &s1_init);
+        robot.destroy();
+        obstacles.destroy();
+        landscape.destroy();
+        universe.reset_space();
+        Bioloid::create_robot(robot, config.robot, std::vector<double>{});
+        Bioloid::create_scene(obstacles, landscape, config.scene);
+        universe.fit_space(config);
+        model_id = config.robot;
+        model_params.clear();
+        model_changed = false;
+        recordSnapshot(robot, obstacles, &s1_init);
+    }
 
-    bool reload_model = false;
+    for (unsigned int i = 0; i < robot.number_of_bodies(); ++i)
+        if (robot.bodies[i].is_fixed())
+            robot.bodies[i].toggle_fixed(universe.world);
+
+    playSnapshot(robot, obstacles, &s1_init);
+    universe.set_gravity(config.initial_gravity);
+    reset();
+    save_user_state(0.0);
+
+    /* flags the client may have changed */
+    low_quality_sensors = false;
+    interlaced_mode     = not pipelined_mode;
+    binary_mode         = false;
+    paused              = false;
+    steps_per_control   = std::max(1, config.steps_per_control);
+    subscription        = Subscription{};
+    compression.disable();
+    deadline            = clock::time_point{};
+    deadline_cycles = missed_deadlines = missed_in_row = max_missed_in_row = 0;
+    reply_overdue       = false;
+
+    if (not connection->next_client()) {
+        dsPrint("Failed to accept the next client.\n");
+        return false;
+    }
+    dsPrint("Connection to client established.\nSending the robot's configuration to client.\n");
+    send_robot_configuration();
+    return true;
+}
 
-    /* reset frame record flag */
-    config.record_frames = false;
+void TCPController::send_status(const double time)
+{
+    if (apply_pending) {
+        apply_time.record(apply_begin, clock::now());
+        apply_pending = false;
+    }
 
-    /* send message to client */
-    if (not interlaced_mode and not paused)
+    /* send message to client, in pipelined mode not before the traits are confirmed,
+       in deadline mode not before the late reply to the last status arrived */
+    if (not interlaced_mode and not paused and not (pipelined_mode and awaiting_ack) and not reply_overdue)
         send_ordered_info(time);
+}
 
-    paused = false; // client must continuously send pause signal
-    while (!done)
-    {
-        /* listen to socket */
-        msg = socketServer->getNextLine();
-
-        /* parse voltage commands */
-        if (starts_with(msg, "UX ")) { parse_voltage_UX(msg.c_str()); continue; } // UX <voltage_0> <voltage_1> ... <voltage_N-1>
-        if (starts_with(msg, "UA ")) { parse_voltage_UA(msg.c_str()); continue; } // UA <voltage>
-        if (starts_with(msg, "UI ")) { parse_voltage_UI(msg.c_str()); continue; } // UI <joint_ID> <voltage>
-
-        /* setpoint for PID controller */
-        if (starts_with(msg, "PX ")) { parse_pidctrl_PX(msg.c_str()); continue; } // PX <position_0> <position_1> ... <position_N-1>
-        if (starts_with(msg, "PA ")) { parse_pidctrl_PA(msg.c_str()); continue; } // PA <position>
-        if (starts_with(msg, "PI ")) { parse_pidctrl_PI(msg.c_str()); continue; } // PI <joint_ID> <position>
-
-        /* max. torque for PID */
-        if (starts_with(msg, "TX ")) { parse_maxtorq_TX(msg.c_str()); continue; } // TX <maxtorque_0> <maxtorque_1> ... <maxtorque_N-1>
-        if (starts_with(msg, "TA ")) { parse_maxtorq_TA(msg.c_str()); continue; } // TA <maxtorque>
-        if (starts_with(msg, "TI ")) { parse_maxtorq_TI(msg.c_str()); continue; } // TI <joint_ID> <maxtorque>
-
-        /* add impulse to body */
-        if (starts_with(msg, "FX ")) { parse_impulse_FX(msg.c_str()); continue; } // FX <force_x_0> <force_y_0> <force_z_0> ... <force_x_N-1> <force_y_N-1> <force_z_N-1>
-        if (starts_with(msg, "FA ")) { parse_impulse_FA(msg.c_str()); continue; } // FA <force_x> <force_y> <force_z>
-        if (starts_with(msg, "FI ")) { parse_impulse_FI(msg.c_str()); continue; } // FI <body_ID> <force_x> <force_y> <force_z>
+bool TCPController::handle_commands(const double time)
+{
+    /* pipelined mode: step on with the current controls until the client
+       is one status behind, its reply then arrives during the next step. */
+    bool done = pipelined_mode and not (paused or awaiting_ack) and unanswered <= action_delay;
+    const bool wait_for_client = not done;
 
-        /* gravity */
-        if (starts_with(msg, "GRAVITY ON" )) { universe.set_gravity(true);  continue; }
-        if (starts_with(msg, "GRAVITY OFF")) { universe.set_gravity(false); continue; }
+    /* deadline mode: the reply must be complete at the end of the control
+       period, otherwise the physics steps on with the current controls and
+       the rest of the reply is read in the next period. */
+    const bool check_deadline = deadline_mode and not awaiting_ack;
+    reply_overdue = false;
 
-        /* reset */
-        if (starts_with(msg, "RESET"  )) { playSnapshot(robot, obstacles, &s1_init); reset(); continue; }
+    unsigned int fail_counter = 0;
+    std::string_view msg; // null-terminated line of the receive buffer
 
-        /* save and restore snapshots */
-        if (starts_with(msg, "SAVE"   )) { dsPrint("Saving state.\n"); recordSnapshot(robot, obstacles, &s2_user); continue; }
-        if (starts_with(msg, "RESTORE")) { playSnapshot  (robot, obstacles, &s2_user); continue; }
-        if (starts_with(msg, "NEWTIME")) { if (reset_time) reset_time(); continue; }
+    /* reset frame record flag */
+    config.record_frames = false;
 
-        /* simulator commands */
-        if (starts_with(msg, "RECORD" )) { config.record_frames = true; continue; }
-        if (starts_with(msg, "PAUSE"  )) { paused = true; continue; }
-        if (starts_with(msg, "DONE"   )) { done = true; continue; }
-        if (starts_with(msg, "EXIT"   )) { dsPrint("Received 'EXIT' command.\n"); return false; }
-        if (starts_with(msg, "ACK"    )) { dsPrint("Received 'ACK', configuration confirmed by client.\n"); done = true; continue; }
+    paused = false; // client must continuously send pause signal
+    current_time = time;
+
+    /* wait for the reply, the bytes may have arrived earlier */
+    clock::time_point receive_begin = clock::now();
+    if (wait_for_client and (not check_deadline or connection->wait_for_input(deadline))) {
+        connection->peek_byte();
+        if (status_pending) think_time.record(status_sent_at, connection->last_receive());
+        receive_begin = std::max(receive_begin, connection->last_receive());
+        status_pending = false;
+    }
 
-        /* model updates */
-        if (starts_with(msg, "MODEL"  )) { reload_model = parse_update_model_command(msg.c_str()); continue; }
-        if (starts_with(msg, "MOTOR"  )) { parse_update_motor_model(msg.c_str()); continue; }
+    while (!done)
+    {
+        if (check_deadline and not connection->wait_for_input(deadline)) {
+            ++deadline_cycles;
+            ++missed_deadlines;
+            max_missed_in_row = std::max(max_missed_in_row, ++missed_in_row);
+            next_deadline();
+            reply_overdue = true;
+            apply_controls();
+            return true;
+        }
 
-        /* sensor quality */
-        if (starts_with(msg, "SENSORS POOR")) { dsPrint("Setting poor sensor quality.\n"); low_quality_sensors = true;  continue; }
-        if (starts_with(msg, "SENSORS GOOD")) { dsPrint("Setting good sensor quality.\n"); low_quality_sensors = false; continue; }
+        /* binary command frames */
+        if (binary_mode and binary_protocol::is_opcode(connection->peek_byte())) {
+            if (parse_binary_command()) continue;
+            return false;
+        }
 
-        /* misc */
-        if (starts_with(msg, "FIXED")) { parse_toggle_fixed(msg.c_str()); continue; }
-        if (starts_with(msg, "DESCRIPTION")) { send_robot_description_str(); continue; }
+        /* listen to socket */
+        msg = connection->getNextLine();
 
-        if (starts_with(msg, "INTERLACED MODE")) { dsPrint("Interlaced mode.\n"); interlaced_mode = true;  continue; }
-        if (starts_with(msg, "SEQUENTIAL MODE")) { dsPrint("Sequential mode.\n"); interlaced_mode = false; continue; }
+        const CommandResult result = execute_command(msg);
+        if (result == next_command  ) continue;
+        if (result == end_of_message) { done = true; continue; }
+        if (result == close_connection) return false;
 
         /* error */
         if (fail_counter++ >= 42) { dsPrint("Too many messages without a 'DONE'-command.\n"); return false; }
 
-        dsPrint("ERROR: unknown command: '%s'\n", msg.c_str());
+        dsPrint("ERROR: unknown command: '%s'\n", msg.data());
+    }
+
+    if (wait_for_client) {
+        receive_time.record(receive_begin, clock::now());
+        if (unanswered > 0) --unanswered;
+    }
+
+    if (deadline_mode and not awaiting_ack) {
+        if (check_deadline) {
+            std::this_thread::sleep_until(deadline); // fixed control rate, the commands take effect at the end of the period
+            ++deadline_cycles;
+            missed_in_row = 0;
+        }
+        next_deadline();
     }
 
     if (reload_model) {
+        reload_model = false;
         reset();
+        binary_mode = false; // new traits handshake starts in text mode
+        subscription = Subscription{};
         recordSnapshot(robot, obstacles, &s1_init);
-        recordSnapshot(robot, obstacles, &s2_user);
+        save_user_state(0.0);
+        if (not episode_steps.empty())
+            create_batch(batch_size(), episode_length); // rebuild with the new model
         //camera.set_viewpoint(robot.get_camera_center_obj(), robot.get_camera_setup());
         send_robot_configuration();
         //wait_for_ack();
     }
     else if (interlaced_mode and not paused)
-        send_ordered_info(time);
+        send_ordered_info(current_time);
 
     if (not paused)
-        execute_controller();
+        apply_controls();
     return true;
 }
 
-void TCPController::send_ordered_info(const double time)
+void TCPController::apply_controls(void)
 {
-    const std::size_t buffer_size = 4096;
-    std::string message;
-    char tmp[buffer_size];
+    apply_begin   = clock::now(); // until the next status, includes the physics step of the caller
+    apply_pending = true;
 
-    // time stamp
-    snprintf(tmp, buffer_size, "%lf ", time);
-    message.append(tmp);
+    /* further batch instances are stepped in parallel */
+    for (BatchInstance* instance : batch)
+        batch_pool->submit([this, instance]() { instance->step(steps_per_control, config.step_length); });
 
-    for (std::size_t i = 0; i < robot.number_of_joints(); ++i)
-        robot.joints[i].read_sensors(low_quality_sensors);
+    execute_controller();
 
+    /* control decimation: hold the commands for the remaining steps,
+       the last step is done by the simulation loop. */
+    for (unsigned int i = 1; i < steps_per_control; ++i) {
+        physics_step();
+        execute_controller();
+    }
 
-    /* angular position */
-    for (std::size_t i = 0; i < robot.number_of_joints(); ++i)
-    {
-        snprintf(tmp, buffer_size, "%lf ", robot.joints[i].get_low_resolution_position());
-        message.append(tmp);
+    if (batch_pool) batch_pool->wait();
+    for (auto& steps : episode_steps) ++steps;
+    sensor_steps += steps_per_control;
+}
+
+void TCPController::next_deadline(void)
+{
+    const clock::duration period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(steps_per_control * config.step_length));
+    deadline += period;
+
+    const clock::time_point now = clock::now();
+    if (deadline < now) deadline = now + period; // first period or the physics fell behind
+}
+
+namespace {
+    /* perfect hash of the first two characters of a command, both upper-case letters */
+    const std::size_t num_command_keys = 26 * 26;
+
+    inline std::size_t command_key(std::string_view token) {
+        if (token.size() < 2 or token[0] < 'A' or token[0] > 'Z' or token[1] < 'A' or token[1] > 'Z')
+            return num_command_keys;
+        return (token[0] - 'A') * 26 + (token[1] - 'A');
     }
+}
+
+/* Commands are looked up by the hash of their first two characters, only
+   tokens sharing these are compared. Each handler receives the whole line,
+   which is null-terminated for the parsers. */
+TCPController::CommandResult TCPController::execute_command(std::string_view msg)
+{
+    struct Command {
+        std::string_view token;
+        CommandResult (*handler)(TCPController& self, std::string_view msg);
+    };
+
+    /* commands with equal first two characters must be adjacent */
+    static const Command commands[] = {
+        /* voltage control */
+        { "UX ", [](TCPController& self, std::string_view msg) { self.parse_voltage_UX(msg.data()); return next_command; } }, // UX <voltage_0> <voltage_1> ... <voltage_N-1>
+        { "UA ", [](TCPController& self, std::string_view msg) { self.parse_voltage_UA(msg.data()); return next_command; } }, // UA <voltage>
+        { "UI ", [](TCPController& self, std::string_view msg) { self.parse_voltage_UI(msg.data()); return next_command; } }, // UI <joint_ID> <voltage>
+
+        /* setpoint for PID controller */
+        { "PX ", [](TCPController& self, std::string_view msg) { self.parse_pidctrl_PX(msg.data()); return next_command; } }, // PX <position_0> <position_1> ... <position_N-1>
+        { "PA ", [](TCPController& self, std::string_view msg) { self.parse_pidctrl_PA(msg.data()); return next_command; } }, // PA <position>
+        { "PAUSE", [](TCPController& self, std::string_view) { self.paused = true; return next_command; } },
+        { "PI ", [](TCPController& self, std::string_view msg) { self.parse_pidctrl_PI(msg.data()); return next_command; } }, // PI <joint_ID> <position>
+
+        /* max. torque for PID */
+        { "TX ", [](TCPController& self, std::string_view msg) { self.parse_maxtorq_TX(msg.data()); return next_command; } }, // TX <maxtorque_0> <maxtorque_1> ... <maxtorque_N-1>
+        { "TA ", [](TCPController& self, std::string_view msg) { self.parse_maxtorq_TA(msg.data()); return next_command; } }, // TA <maxtorque>
+        { "TI ", [](TCPController& self, std::string_view msg) { self.parse_maxtorq_TI(msg.data()); return next_command; } }, // TI <joint_ID> <maxtorque>
+
+        /* add impulse to body */
+        { "FX ", [](TCPController& self, std::string_view msg) { self.parse_impulse_FX(msg.data()); return next_command; } }, // FX <force_x_0> <force_y_0> <force_z_0> ... <force_x_N-1> <force_y_N-1> <force_z_N-1>
+        { "FA ", [](TCPController& self, std::string_view msg) { self.parse_impulse_FA(msg.data()); return next_command; } }, // FA <force_x> <force_y> <force_z>
+        { "FI ", [](TCPController& self, std::string_view msg) { self.parse_impulse_FI(msg.data()); return next_command; } }, // FI <body_ID> <force_x> <force_y> <force_z>
+        { "FIXED", [](TCPController& self, std::string_view msg) { self.parse_toggle_fixed(msg.data()); return next_command; } },
+
+        /* gravity */
+        { "GRAVITY ON" , [](TCPController& self, std::string_view) { self.set_gravity(true);  return next_command; } },
+        { "GRAVITY OFF", [](TCPController& self, std::string_view) { self.set_gravity(false); return next_command; } },
+
+        /* solver */
+        { "SOLVER ", [](TCPController& self, std::string_view msg) { self.parse_solver(msg.data()); return next_command; } }, // SOLVER STEP | SOLVER QUICK [<iterations> [<SOR>]]
+
+        /* reset, save and restore snapshots */
+        { "RESET"  , [](TCPController& self, std::string_view) { playSnapshot(self.robot, self.obstacles, &self.s1_init); self.reset(); self.reset_batch(); return next_command; } },
+        { "RESTORE", [](TCPController& self, std::string_view) { playSnapshot(self.robot, self.obstacles, &self.s2_user); return next_command; } },
+        { "RECORD" , [](TCPController& self, std::string_view) { self.config.record_frames = true; return next_command; } },
+        { "SAVE"   , [](TCPController& self, std::string_view) { dsPrint("Saving state.\n"); self.save_user_state(self.current_time); return next_command; } },
+        { "NEWTIME", [](TCPController& self, std::string_view) { if (self.set_time) self.set_time(0.0); return next_command; } },
+        { "GETSTATE", [](TCPController& self, std::string_view) { self.send_state(); return next_command; } },
+
+        /* simulator commands */
+        { "STEP "    , [](TCPController& self, std::string_view msg) { self.parse_steps_per_control(msg.data()); return next_command; } }, // STEP <number of physics steps>
+        { "STATS"    , [](TCPController& self, std::string_view) { self.print_statistics(); return next_command; } },
+        { "SUBSCRIBE", [](TCPController& self, std::string_view msg) { self.parse_subscription(msg.data()); return next_command; } }, // SUBSCRIBE <channel>[:<first>[-<last>]] ...
+        { "ROLLOUT " , [](TCPController& self, std::string_view msg) { self.parse_rollout(msg.data()); return next_command; } },       // ROLLOUT <K> [RESTORE] <voltage_0_0> ... <voltage_K-1_N-1>
+        { "BATCH "   , [](TCPController& self, std::string_view msg) { self.parse_batch(msg.data()); return next_command; } },         // BATCH <B> [<episode_length>]
+        { "COMPRESSION", [](TCPController& self, std::string_view msg) { self.parse_compression(msg.data()); return next_command; } }, // COMPRESSION <resolution> [<keyframe_interval>] | OFF
+        { "DONE"     , [](TCPController&     , std::string_view) { return end_of_message; } },
+        { "EXIT"     , [](TCPController&     , std::string_view) { dsPrint("Received 'EXIT' command.\n"); return close_connection; } },
+        { "ACK"      , [](TCPController& self, std::string_view) { dsPrint("Received 'ACK', configuration confirmed by client.\n"); self.awaiting_ack = false; return end_of_message; } },
+
+        /* model updates */
+        { "MODEL", [](TCPController& self, std::string_view msg) { self.reload_model = self.parse_update_model_command(msg.data()); return next_command; } },
+        { "MOTOR", [](TCPController& self, std::string_view msg) { self.parse_update_motor_model(msg.data()); return next_command; } },
+
+        /* sensor quality and modes */
+        { "SENSORS POOR"   , [](TCPController& self, std::string_view) { dsPrint("Setting poor sensor quality.\n"); self.low_quality_sensors = true; self.reset_derived_sensors(); return next_command; } },
+        { "SENSORS GOOD"   , [](TCPController& self, std::string_view) { dsPrint("Setting good sensor quality.\n"); self.low_quality_sensors = false; return next_command; } },
+        { "SEQUENTIAL MODE", [](TCPController& self, std::string_view) { self.set_interlaced_mode(false); return next_command; } },
+        { "SETSTATE "      , [](TCPController& self, std::string_view msg) { self.parse_set_state(msg.data()); return next_command; } }, // SETSTATE <bytes>, followed by the blob of GETSTATE
+        { "INTERLACED MODE", [](TCPController& self, std::string_view) { self.set_interlaced_mode(true);  return next_command; } },
+        { "BINARY MODE"    , [](TCPController& self, std::string_view) { dsPrint("Binary protocol.\n"); self.binary_mode = true; self.compression.request_keyframe(); return next_command; } },
+        { "TEXT MODE"      , [](TCPController& self, std::string_view) { dsPrint("Text protocol.\n"  ); self.binary_mode = false; return next_command; } },
+
+        /* misc */
+        { "DESCRIPTION", [](TCPController& self, std::string_view) { self.send_robot_description_str(); return next_command; } },
+        { "DEADLINES"  , [](TCPController& self, std::string_view) { self.send_deadline_statistics(); return next_command; } },
+    };
+    const std::size_t num_commands = sizeof(commands) / sizeof(commands[0]);
+
+    /* index of the first command per key, num_commands if there is none */
+    static const auto first = []() {
+        std::array<uint8_t, num_command_keys + 1> index;
+        index.fill(num_commands);
+        for (std::size_t i = num_commands; i-- > 0; )
+            index[command_key(commands[i].token)] = i;
+        return index;
+    }();
+
+    const std::size_t key = command_key(msg);
+    for (std::size_t i = first[key]; i < num_commands and command_key(commands[i].token) == key; ++i)
+        if (msg.compare(0, commands[i].token.size(), commands[i].token) == 0)
+            return commands[i].handler(*this, msg);
+
+    return unknown_command;
+}
+
+void TCPController::collect_ordered_info(const double time)
+{
+    /* the derived sensors span all physics steps since the last status */
+    const double dt = std::max(1u, sensor_steps) * config.step_length;
+    sensor_steps = 0;
+
+    status.clear();
+    collect_robot_info(robot, time, dt);
+    for (BatchInstance* instance : batch)
+        collect_robot_info(instance->get_robot(), instance->get_time(), dt);
+}
+
+void TCPController::collect_robot_info(Robot& instance, const double time, const double dt)
+{
+    auto const& sub_pos = subscription[ch_position];
+    auto const& sub_vel = subscription[ch_velocity];
+    auto const& sub_cur = subscription[ch_current ];
+    auto const& sub_acc = subscription[ch_accel   ];
+    auto const& sub_bp  = subscription[ch_body_pos];
+    auto const& sub_bv  = subscription[ch_body_vel];
+
+    const std::size_t num_joints = instance.number_of_joints();
+    const std::size_t num_accels = instance.number_of_accels();
+    const std::size_t num_bodies = instance.number_of_bodies();
+
+    // time stamp
+    if (subscription[ch_time].enabled)
+        status.push_back(time);
+
+    for (std::size_t i = 0; i < num_joints; ++i)
+        if (sub_pos.contains(i) or sub_vel.contains(i))
+            instance.joints[i].read_sensors(low_quality_sensors, dt);
+
+    /* angular position */
+    for (std::size_t i = sub_pos.begin(num_joints); i < sub_pos.end(num_joints); ++i)
+        status.push_back(instance.joints[i].get_low_resolution_position());
 
     /* angular velocity */
-    for (std::size_t i = 0; i < robot.number_of_joints(); ++i)
-    {
-        snprintf(tmp, buffer_size, "%lf ", robot.joints[i].get_low_resolution_velocity());
-        message.append(tmp);
-    }
+    for (std::size_t i = sub_vel.begin(num_joints); i < sub_vel.end(num_joints); ++i)
+        status.push_back(instance.joints[i].get_low_resolution_velocity());
 
     /* motor current */
-    for (std::size_t i = 0; i < robot.number_of_joints(); ++i)
-    {
-        snprintf(tmp, buffer_size, "%lf ", robot.joints[i].get_current());//TODO: low_resolution 10bit
-        message.append(tmp);
-    }
+    for (std::size_t i = sub_cur.begin(num_joints); i < sub_cur.end(num_joints); ++i)
+        status.push_back(instance.joints[i].get_current()); //TODO: low_resolution 10bit
 
     /* acceleration */
-    for (std::size_t i = 0; i < robot.number_of_accels(); ++i)
+    for (std::size_t i = sub_acc.begin(num_accels); i < sub_acc.end(num_accels); ++i)
     {
-        const Vector3& acc = robot.accels[i].update();
-        snprintf(tmp, buffer_size, "%lf %lf %lf ", acc.x, acc.y, acc.z);
-        message.append(tmp);
+        const Vector3& acc = instance.accels[i].update(dt);
+        status.push_back(acc.x);
+        status.push_back(acc.y);
+        status.push_back(acc.z);
     }
 
     /* body locations + velocities */
-    for (std::size_t i = 0; i < robot.number_of_bodies(); ++i)
+    for (std::size_t i = 0; i < num_bodies; ++i)
     {
-        const Vector3& pos = robot.bodies[i].get_position();
-        const Vector3& vel = robot.bodies[i].get_velocity();
-        snprintf( tmp, buffer_size, "%lf %lf %lf %lf %lf %lf "
-                , pos.x, pos.y, pos.z, vel.x, vel.y, vel.z );
-        message.append(tmp);
+        if (sub_bp.contains(i)) {
+            const Vector3& pos = instance.bodies[i].get_position();
+            status.push_back(pos.x);
+            status.push_back(pos.y);
+            status.push_back(pos.z);
+        }
+        if (sub_bv.contains(i)) {
+            const Vector3& vel = instance.bodies[i].get_velocity();
+            status.push_back(vel.x);
+            status.push_back(vel.y);
+            status.push_back(vel.z);
+        }
     }
 
     /**TODO:
@@ -178,10 +403,35 @@ void TCPController::send_ordered_info(const double time)
      * Is it sufficient to only provide a sum power value, or should we provide it for each joint?
      * Shall we instead of power provide the motor current?
      */
+}
+
+void TCPController::send_ordered_info(double time)
+{
+    if (not episode_steps.empty())
+        time = reset_finished_instances(time);
+
+    const clock::time_point begin = clock::now();
+    collect_ordered_info(time);
+
+    /* binary: fixed-layout frame, header + float64 values in the order of the text message */
+    if (binary_mode and compression.enabled())
+        compression.encode(status, writer);
+    else {
+        writer.start(binary_mode);
+        writer.append(status);
+    }
 
     /* send message to socket */
-    if (!socketServer->send_message(message))
-        dsError("Could not send ordered info message to client!\n");
+    if (!writer.send(*connection))
+        dsPrint("ERROR: could not send ordered info message to client!\n"); // next read will fail and end the session
+    ++unanswered;
+
+    status_sent_at = clock::now();
+    status_pending = true;
+    send_time.record(begin, status_sent_at);
+
+    if (observer and ++observed_statuses % std::max(1, config.observer_interval) == 0)
+        observer->publish(status);
 }
 
 void TCPController::send_robot_configuration()
@@ -212,15 +462,38 @@ void TCPController::send_robot_configuration()
         message.append(tmp);
     }
 
+    /* control steps until a control message takes effect, only sent in pipelined mode */
+    if (pipelined_mode) {
+        snprintf(tmp, buffer_size, "action_delay %u\n", action_delay);
+        message.append(tmp);
+    }
+
     /* send message to socket */
-    if (!socketServer->send_message(message))
-        dsError("Could not send robot configuration message to client.\n");
+    if (!connection->send_message(message))
+        dsPrint("ERROR: could not send robot configuration message to client.\n");
+
+    writer.reserve(batch_size() * status_size(robot));
+
+    /* status messages still on their way are void, the client answers with 'ACK' */
+    unanswered = 0;
+    awaiting_ack = true;
+    status_pending = false;
+}
+
+void TCPController::set_interlaced_mode(const bool interlaced)
+{
+    if (pipelined_mode) {
+        dsPrint("ERROR: mode can not be changed in pipelined mode.\n");
+        return;
+    }
+    dsPrint(interlaced ? "Interlaced mode.\n" : "Sequential mode.\n");
+    interlaced_mode = interlaced;
 }
 
 //bool TCPController::wait_for_ack(void)
 //{
 //    dsPrint("Waiting for acknowledge.\n");
-//    std::string ack = socketServer->getNextLine();
+//    std::string ack = connection->getNextLine();
 //
 //    if (ack.compare(0, 3, "ACK") == 0)
 //        dsPrint("Acknowledge for configuration received.\n");
@@ -236,11 +509,25 @@ void TCPController::execute_controller()
     robot.joints.apply_control_all();
 }
 
+void TCPController::print_statistics(void) const
+{
+    dsPrint("Protocol timing of %lu control cycles:\n", apply_time.count());
+    think_time  .print("think");
+    receive_time.print("receive");
+    apply_time  .print("apply");
+    send_time   .print("send");
+    universe.print_collision_counts();
+    if (deadline_mode)
+        dsPrint("Deadlines: %lu of %lu control cycles missed, at most %lu in a row.\n", missed_deadlines, deadline_cycles, max_missed_in_row);
+    if (observer)
+        dsPrint("Observer broadcast: %lu frames sent, %lu dropped.\n", observer->frames_sent(), observer->frames_dropped());
+}
+
 void TCPController::reset()
 {
     robot.joints.reset_all();
     robot.accels.reset_all();
-    if (reset_time) reset_time();
+    if (set_time) set_time(0.0);
 }
 
 void TCPController::parse_pidctrl_PA(const char* msg)
@@ -249,8 +536,9 @@ void TCPController::parse_pidctrl_PA(const char* msg)
 
     if (1 == sscanf(msg, "PA %lf", &value))
     {
-        for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
-             robot.joints[idx].set_position(value);
+        for (std::size_t k = 0; k < batch_size(); ++k)
+            for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
+                instance_robot(k).joints[idx].set_position(value);
     }
     else dsPrint("ERROR: bad 'PA' format: '%s'\n", msg);
 }
@@ -260,13 +548,15 @@ void TCPController::parse_pidctrl_PX(const char* msg)
     int offset = 2;
     double value = 0.0;
 
+    const std::size_t num_joints = robot.number_of_joints();
+
     msg += offset;
-    for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
+    for (unsigned int idx = 0; idx < batch_size() * num_joints; ++idx)
     {
         if (1 == sscanf(msg, " %lf%n", &value, &offset))
         {
             msg += offset;
-             robot.joints[idx].set_position(value);
+            instance_robot(idx / num_joints).joints[idx % num_joints].set_position(value);
         }
         else {
             dsPrint("ERROR: bad 'PX' format: '%s'\n", msg);
@@ -280,12 +570,14 @@ void TCPController::parse_pidctrl_PI(const char* msg)
     unsigned int idx = 0;
     double value = 0.0;
 
+    const std::size_t num_joints = robot.number_of_joints();
+
     if (2 == sscanf(msg, "PI %u %lf", &idx, &value))
     {
-        if (idx < robot.number_of_joints())
-            robot.joints[idx].set_position(value);
+        if (idx < batch_size() * num_joints)
+            instance_robot(idx / num_joints).joints[idx % num_joints].set_position(value);
         else
-            dsPrint("ERROR: joint value out of range (0...%u): '%s'\n", robot.number_of_joints() - 1, msg);
+            dsPrint("ERROR: joint value out of range (0...%zu): '%s'\n", batch_size() * num_joints - 1, msg);
     }
     else dsPrint("ERROR: bad 'PI' format: '%s'\n", msg);
 }
@@ -298,8 +590,9 @@ void TCPController::parse_maxtorq_TA(const char* msg)
     {
         if ((value >= 0) && (value <= 1.0))
         {
-            for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
-                robot.joints[idx].set_pidmaxtorque(value);
+            for (std::size_t k = 0; k < batch_size(); ++k)
+                for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
+                    instance_robot(k).joints[idx].set_pidmaxtorque(value);
         }
         else dsPrint("ERROR: value out of range (0...+1): '%s'\n", msg);
     }
@@ -311,13 +604,15 @@ void TCPController::parse_maxtorq_TX(const char* msg)
     unsigned int offset = 2;
     double value = 0.0;
 
+    const std::size_t num_joints = robot.number_of_joints();
+
     msg += offset;
-    for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
+    for (unsigned int idx = 0; idx < batch_size() * num_joints; ++idx)
     {
         if (1 == sscanf(msg, " %lf%n", &value, &offset))
         {
             msg += offset;
-            robot.joints[idx].set_pidmaxtorque(value);
+            instance_robot(idx / num_joints).joints[idx % num_joints].set_pidmaxtorque(value);
         }
         else {
             dsPrint("ERROR: bad 'TX' format: '%s'\n", msg);
@@ -331,12 +626,14 @@ void TCPController::parse_maxtorq_TI(const char* msg)
     unsigned int idx = 0;
     double value = 0.0;
 
+    const std::size_t num_joints = robot.number_of_joints();
+
     if (2 == sscanf(msg, "TI %u %lf", &idx, &value))
     {
-        if (idx < robot.number_of_joints())
-            robot.joints[idx].set_pidmaxtorque(value);
+        if (idx < batch_size() * num_joints)
+            instance_robot(idx / num_joints).joints[idx % num_joints].set_pidmaxtorque(value);
         else
-            dsPrint("ERROR: joint number out of range (0...%u): '%s'\n", robot.number_of_joints() - 1, msg);
+            dsPrint("ERROR: joint number out of range (0...%zu): '%s'\n", batch_size() * num_joints - 1, msg);
 
     }
     else dsPrint("ERROR: bad 'TI' format: '%s'\n", msg);
@@ -347,8 +644,9 @@ void TCPController::parse_voltage_UA(const char* msg)
     double value = 0.0;
     if (1 == sscanf(msg, "UA %lf", &value))
     {
-        for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
-            robot.joints[idx].set_voltage(value);
+        for (std::size_t k = 0; k < batch_size(); ++k)
+            for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
+                instance_robot(k).joints[idx].set_voltage(value);
     }
     else dsPrint("ERROR: bad 'UA' format: '%s'\n", msg);
 }
@@ -358,12 +656,14 @@ void TCPController::parse_voltage_UX(const char* msg)
     int offset = 2;
     double value = 0.0;
 
+    const std::size_t num_joints = robot.number_of_joints();
+
     msg += offset;
-    for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
+    for (unsigned int idx = 0; idx < batch_size() * num_joints; ++idx)
     {
         if (1 == sscanf(msg, " %lf%n", &value, &offset)) {
             msg += offset;
-            robot.joints[idx].set_voltage(value);
+            instance_robot(idx / num_joints).joints[idx % num_joints].set_voltage(value);
         } else {
             dsPrint("ERROR: bad 'UX' format: '%s'\n", msg);
             break;
@@ -376,12 +676,14 @@ void TCPController::parse_voltage_UI(const char* msg)
     unsigned int idx = 0;
     double value = 0.0;
 
+    const std::size_t num_joints = robot.number_of_joints();
+
     if (2 == sscanf(msg, "UI %u %lf", &idx, &value))
     {
-        if (idx < robot.number_of_joints())
-            robot.joints[idx].set_voltage(value);
+        if (idx < batch_size() * num_joints)
+            instance_robot(idx / num_joints).joints[idx % num_joints].set_voltage(value);
         else
-            dsPrint("ERROR: value #1 out of range (0...%u): '%s'\n", robot.number_of_joints() - 1, msg);
+            dsPrint("ERROR: value #1 out of range (0...%zu): '%s'\n", batch_size() * num_joints - 1, msg);
     }
     else dsPrint("ERROR: bad 'UI' format: '%s'\n", msg);
 }
@@ -391,8 +693,9 @@ void TCPController::parse_impulse_FA(const char* msg)
     Vector3 force(0.0);
     if (3 == sscanf(msg, "FA %lf %lf %lf", &force.x, &force.y, &force.z))
     {
-        for (unsigned int idx = 0; idx < robot.number_of_bodies(); ++idx)
-            robot.bodies[idx].set_impulse(force);
+        for (std::size_t k = 0; k < batch_size(); ++k)
+            for (unsigned int idx = 0; idx < robot.number_of_bodies(); ++idx)
+                instance_robot(k).bodies[idx].set_impulse(force);
     }
     else dsPrint("ERROR: bad 'FA' format: '%s'\n", msg);
 }
@@ -402,12 +705,14 @@ void TCPController::parse_impulse_FX(const char* msg)
     int offset = 2;
     Vector3 force(0.0);
 
+    const std::size_t num_bodies = robot.number_of_bodies();
+
     msg += offset;
-    for (unsigned int idx = 0; idx < robot.number_of_bodies(); ++idx)
+    for (unsigned int idx = 0; idx < batch_size() * num_bodies; ++idx)
     {
         if (3 == sscanf(msg, " %lf %lf %lf%n", &force.x, &force.y, &force.z, &offset)) {
             msg += offset;
-            robot.bodies[idx].set_impulse(force);
+            instance_robot(idx / num_bodies).bodies[idx % num_bodies].set_impulse(force);
         } else {
             dsPrint("ERROR: bad 'FX' format: '%s'\n", msg);
             break;
@@ -420,12 +725,14 @@ void TCPController::parse_impulse_FI(const char* msg)
     unsigned int idx = 0;
     Vector3 force(0.0);
 
+    const std::size_t num_bodies = robot.number_of_bodies();
+
     if (sscanf(msg, "FI %u %lf %lf %lf", &idx, &force.x, &force.y, &force.z) == 4)
     {
-        if (idx < robot.number_of_bodies())
-            robot.bodies[idx].set_impulse(force);
+        if (idx < batch_size() * num_bodies)
+            instance_robot(idx / num_bodies).bodies[idx % num_bodies].set_impulse(force);
         else
-            dsPrint("ERROR: value #1 out of range (0...%u): '%s'\n", robot.number_of_bodies() - 1, msg);
+            dsPrint("ERROR: value #1 out of range (0...%zu): '%s'\n", batch_size() * num_bodies - 1, msg);
     }
     else dsPrint("ERROR: bad 'FI' format: '%s'\n", msg);
 }
@@ -444,7 +751,7 @@ std::vector<double> read_params(const char* msg, int* offset, unsigned num_param
                 msg += (*offset);
                 params.emplace_back(p);
             } else {
-                dsPrint("ERROR: bad parameter format for 'MODEL' : '%s'\n", msg);
+                dsPrint("ERROR: bad parameter format: '%s'\n", msg);
                 return {};
             }
         }
@@ -473,8 +780,14 @@ bool TCPController::parse_update_model_command(const char* msg)
     robot.destroy();
     obstacles.destroy();
     landscape.destroy();
+    universe.reset_space();
     Bioloid::create_robot(robot, new_model_id, params);
-    Bioloid::create_scene(obstacles, landscape);
+    Bioloid::create_scene(obstacles, landscape, config.scene);
+    universe.fit_space(config); // tuned to the new geoms
+
+    model_id      = new_model_id;
+    model_params  = params;
+    model_changed = true;
     return true;
 }
 
@@ -494,8 +807,10 @@ void TCPController::parse_update_motor_model(const char* msg) {
     auto params = read_params(msg, &offset, num_params);
 
     dsPrint("Reinitializing actuator model with %u parameters.\n", num_params);
-    for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
-        robot.joints[idx].reinit_motormodel(ActuatorParameters(params));
+    for (std::size_t k = 0; k < batch_size(); ++k)
+        for (unsigned int idx = 0; idx < robot.number_of_joints(); ++idx)
+            instance_robot(k).joints[idx].reinit_motormodel(ActuatorParameters(params));
+    model_changed = true;
 
     return;
 }
@@ -507,14 +822,431 @@ void TCPController::parse_toggle_fixed(const char* msg)
 
     if (sscanf(msg, "FIXED %u", &idx) == 1)
     {
-        if (idx < robot.number_of_bodies())
+        if (idx < robot.number_of_bodies()) {
             robot.bodies[idx].toggle_fixed(universe.world);
+            for (BatchInstance* instance : batch)
+                instance->toggle_fixed(idx);
+        }
         else
             dsPrint("ERROR: value #1 out of range (0...%u): '%s'\n", robot.number_of_bodies() - 1, msg);
     }
     else dsPrint("ERROR: bad 'FIXED' format: '%s'\n", msg);
 }
 
+void TCPController::set_gravity(bool enable)
+{
+    universe.set_gravity(enable);
+    for (BatchInstance* instance : batch)
+        instance->set_gravity(enable);
+}
+
+
+bool TCPController::parse_binary_command(void)
+{
+    using namespace binary_protocol;
+
+    std::string_view header, payload;
+    if (not connection->get_bytes(command_header_size, header))
+        return false; // client is gone
+
+    const uint8_t  opcode = static_cast<uint8_t>(header[0]);
+    const uint32_t count  = get_u32(&header[1]);
+
+    if (count > max_values) {
+        dsPrint("ERROR: binary frame with %u values exceeds limit.\n", count);
+        return false; // stream can not be re-synchronized
+    }
+
+    if (not connection->get_bytes(count * value_size(opcode), payload))
+        return false;
+
+    const char* data = payload.data();
+    const std::size_t num_joints = robot.number_of_joints();
+
+    switch (opcode & ~float32_flag)
+    {
+        case ROLLOUT:
+        case ROLLOUT_RESTORE:
+        {
+            if (count == 0 or count % num_joints != 0 or count / num_joints > constants::max_rollout_steps or not batch.empty()) break;
+            std::vector<double> voltages(count);
+            for (unsigned int idx = 0; idx < count; ++idx)
+                voltages[idx] = get_value(data, idx, opcode);
+            rollout(voltages, current_time, (opcode & ~float32_flag) == ROLLOUT_RESTORE);
+            return true;
+        }
+
+        case UX:
+            if (count != batch_size() * num_joints) break;
+            for (unsigned int idx = 0; idx < count; ++idx)
+                instance_robot(idx / num_joints).joints[idx % num_joints].set_voltage(get_value(data, idx, opcode));
+            return true;
+
+        case PX:
+            if (count != batch_size() * num_joints) break;
+            for (unsigned int idx = 0; idx < count; ++idx)
+                instance_robot(idx / num_joints).joints[idx % num_joints].set_position(get_value(data, idx, opcode));
+            return true;
+
+        case TX:
+            if (count != batch_size() * num_joints) break;
+            for (unsigned int idx = 0; idx < count; ++idx)
+                instance_robot(idx / num_joints).joints[idx % num_joints].set_pidmaxtorque(get_value(data, idx, opcode));
+            return true;
+
+        case FX:
+        {
+            const std::size_t num_bodies = robot.number_of_bodies();
+            if (count != 3 * batch_size() * num_bodies) break;
+            for (unsigned int idx = 0; idx < batch_size() * num_bodies; ++idx)
+                instance_robot(idx / num_bodies).bodies[idx % num_bodies].set_impulse(Vector3( get_value(data, 3*idx + 0, opcode)
+                                                                                             , get_value(data, 3*idx + 1, opcode)
+                                                                                             , get_value(data, 3*idx + 2, opcode) ));
+            return true;
+        }
+    }
+
+    dsPrint("ERROR: bad binary frame (opcode 0x%02x) with %u values.\n", opcode, count);
+    return true; // payload consumed, stream is still in sync
+}
+
+
+void TCPController::parse_steps_per_control(const char* msg)
+{
+    unsigned int steps = 0;
+
+    if (sscanf(msg, "STEP %u", &steps) == 1 and steps > 0)
+        steps_per_control = steps;
+    else
+        dsPrint("ERROR: bad 'STEP' format: '%s'\n", msg);
+}
+
+
+void TCPController::parse_subscription(const char* msg)
+{
+    const char* names[num_status_channels] = { "time", "pos", "vel", "current", "accel", "body_pos", "body_vel" };
+
+    int offset = 9;
+    msg += offset;
+
+    Subscription result;
+    for (auto& ch : result) ch.enabled = false;
+
+    char token[64];
+    bool empty = true;
+    while (1 == sscanf(msg, " %63s%n", token, &offset))
+    {
+        msg += offset;
+        empty = false;
+
+        if (strcmp(token, "ALL") == 0) {
+            result = Subscription{};
+            continue;
+        }
+
+        /* split into channel name and optional index range */
+        char* range = strchr(token, ':');
+        if (range != nullptr) *range++ = '\0';
+
+        unsigned int ch = 0;
+        while (ch < num_status_channels and strcmp(token, names[ch]) != 0) ++ch;
+        if (ch == num_status_channels) {
+            dsPrint("ERROR: unknown channel in 'SUBSCRIBE': '%s'\n", token);
+            return;
+        }
+
+        ChannelRange channel;
+        if (range != nullptr) {
+            unsigned int first = 0, last = 0;
+            const int n = sscanf(range, "%u-%u", &first, &last);
+            if (n < 1 or (n == 2 and last < first)) {
+                dsPrint("ERROR: bad index range in 'SUBSCRIBE': '%s'\n", range);
+                return;
+            }
+            channel.first = first;
+            channel.last  = (n == 2) ? last + 1 : first + 1; // inclusive in command
+        }
+        result[ch] = channel;
+    }
+
+    if (empty) {
+        dsPrint("ERROR: bad 'SUBSCRIBE' format, no channels given.\n");
+        return;
+    }
+
+    subscription = result;
+    compression.request_keyframe();
+    reset_derived_sensors();
+}
+
+/* The accels and low quality joint velocities are derived from the state at
+   the last reading. Sensors which were not subscribed were not read for a
+   while, their first reading would span all that time. */
+void TCPController::reset_derived_sensors(void)
+{
+    for (std::size_t k = 0; k < batch_size(); ++k) {
+        instance_robot(k).joints.reset_sensors_all();
+        instance_robot(k).accels.reset_all();
+    }
+}
+
+void TCPController::parse_compression(const char* msg)
+{
+    double resolution = 0.0;
+    unsigned int interval = StatusCompression::default_keyframe_interval;
+
+    if (strncmp(msg, "COMPRESSION OFF", 15) == 0) {
+        dsPrint("Uncompressed status.\n");
+        compression.disable();
+    }
+    else if (sscanf(msg, "COMPRESSION %lf %u", &resolution, &interval) >= 1 and resolution > 0.0) {
+        dsPrint("Compressed status, resolution %g, keyframe every %u frames.\n", resolution, interval);
+        compression.enable(resolution, interval);
+    }
+    else
+        dsPrint("ERROR: bad 'COMPRESSION' format: '%s'\n", msg);
+}
+
+void TCPController::parse_solver(const char* msg)
+{
+    int iterations = config.quickstep_iterations;
+    double sor = config.quickstep_SOR;
+
+    if (strncmp(msg, "SOLVER STEP", 11) == 0) {
+        dsPrint("Solver: dWorldStep.\n");
+        config.quick_step = false;
+    }
+    else if (strncmp(msg, "SOLVER QUICK", 12) == 0
+             and sscanf(msg, "SOLVER QUICK %d %lf", &iterations, &sor) != 0 // iterations and SOR are optional
+             and iterations > 0 and sor > 0.0)
+    {
+        dsPrint("Solver: dWorldQuickStep, %d iterations, SOR %g.\n", iterations, sor);
+        config.quick_step           = true;
+        config.quickstep_iterations = iterations;
+        config.quickstep_SOR        = sor;
+    }
+    else {
+        dsPrint("ERROR: bad 'SOLVER' format: '%s'\n", msg);
+        return;
+    }
+
+    universe.set_solver(config);
+    for (BatchInstance* instance : batch)
+        instance->set_solver(config);
+}
+
+void TCPController::parse_batch(const char* msg)
+{
+    unsigned int size = 0, length = 0;
+
+    if (sscanf(msg, "BATCH %u %u", &size, &length) >= 1 and size > 0 and size <= constants::max_batch_size)
+        create_batch(size, length);
+    else
+        dsPrint("ERROR: bad 'BATCH' format: '%s'\n", msg);
+}
+
+/* builds size-1 further worlds of the current model, each instance is
+   reset automatically after length control steps (0 = never) or when
+   its state diverged. */
+void TCPController::create_batch(const unsigned int size, const unsigned int length)
+{
+    clear_batch();
+    dsPrint("Creating batch of %u instances.\n", size);
+
+    for (unsigned int k = 1; k < size; ++k)
+    {
+        batch.push_back(new BatchInstance(config, model_id, model_params));
+        batch.back()->set_solver(config);
+
+        /* same gravity and fixed bodies as instance 0 */
+        if (universe.has_gravity() != config.initial_gravity)
+            batch.back()->set_gravity(universe.has_gravity());
+        for (unsigned int i = 0; i < robot.number_of_bodies(); ++i)
+            if (robot.bodies[i].is_fixed())
+                batch.back()->toggle_fixed(i);
+    }
+
+    if (size > 1) {
+        const unsigned int num_threads = std::min(size - 1, std::max(1u, std::thread::hardware_concurrency()));
+        batch_pool = new ThreadPool(num_threads, []() { dAllocateODEDataForThread(dAllocateMaskAll); });
+    }
+
+    episode_steps.assign(size, 0);
+    episode_length = length;
+    writer.reserve(size * status_size(robot));
+    compression.request_keyframe();
+
+    /* all instances start from the initial state, fixed bodies are fixed there */
+    playSnapshot(robot, obstacles, &s1_init);
+    for (unsigned int i = 0; i < robot.number_of_bodies(); ++i)
+        if (robot.bodies[i].is_fixed()) {
+            robot.bodies[i].toggle_fixed(universe.world);
+            robot.bodies[i].toggle_fixed(universe.world);
+        }
+    reset();
+    current_time = 0.0;
+}
+
+void TCPController::clear_batch(void)
+{
+    delete batch_pool;
+    batch_pool = nullptr;
+
+    for (BatchInstance* instance : batch)
+        delete instance;
+    batch.clear();
+
+    episode_steps.clear();
+    episode_length = 0;
+}
+
+void TCPController::reset_batch(void)
+{
+    for (BatchInstance* instance : batch)
+        instance->reset();
+    std::fill(episode_steps.begin(), episode_steps.end(), 0);
+}
+
+/* auto-reset of finished episodes, returns the (new) time of the own robot */
+double TCPController::reset_finished_instances(const double time)
+{
+    double result = time;
+    for (std::size_t k = 0; k < batch_size(); ++k)
+    {
+        const bool finished = (episode_length > 0 and episode_steps[k] >= episode_length)
+                           or has_diverged(instance_robot(k));
+        if (not finished) continue;
+
+        if (k == 0) {
+            playSnapshot(robot, obstacles, &s1_init);
+            reset();
+            result = 0.0;
+        }
+        else batch[k-1]->reset();
+
+        episode_steps[k] = 0;
+    }
+    return result;
+}
+
+void TCPController::parse_rollout(const char* msg)
+{
+    int offset = 7;
+    msg += offset;
+
+    if (not batch.empty()) {
+        dsPrint("ERROR: 'ROLLOUT' is not available in batch mode.\n");
+        return;
+    }
+
+    unsigned int num_steps = 0;
+    if (1 != sscanf(msg, " %u%n", &num_steps, &offset) or num_steps == 0 or num_steps > constants::max_rollout_steps) {
+        dsPrint("ERROR: bad 'ROLLOUT' format: '%s'\n", msg);
+        return;
+    }
+    msg += offset;
+
+    const bool restore = (strncmp(msg, " RESTORE", 8) == 0);
+    if (restore) msg += 8;
+
+    auto voltages = read_params(msg, &offset, num_steps * robot.number_of_joints());
+    if (voltages.empty()) {
+        dsPrint("ERROR: 'ROLLOUT' needs %u voltage vectors.\n", num_steps);
+        return;
+    }
+    rollout(voltages, current_time, restore);
+}
+
+/* open-loop trajectory: apply one voltage vector per control step and
+   reply with all resulting status vectors in one message */
+void TCPController::rollout(std::vector<double> const& voltages, const double time, const bool restore)
+{
+    const std::size_t num_joints = robot.number_of_joints();
+    const std::size_t num_steps = voltages.size() / num_joints;
+    assert(num_steps * num_joints == voltages.size());
+
+    double t = time;
+    writer.start(binary_mode, binary_protocol::rollout);
+
+    for (std::size_t k = 0; k < num_steps; ++k)
+    {
+        for (std::size_t idx = 0; idx < num_joints; ++idx)
+            robot.joints[idx].set_voltage(voltages[k * num_joints + idx]);
+
+        for (unsigned int i = 0; i < steps_per_control; ++i) {
+            execute_controller();
+            physics_step();
+            t += config.step_length;
+        }
+        sensor_steps += steps_per_control;
+
+        collect_ordered_info(t);
+        writer.append(status);
+        writer.end_record();
+    }
+
+    current_time = t; // simulation time has advanced
+
+    /* the saved state including the joints' controllers and the time */
+    if (restore and restoreState(robot, obstacles, user_state, t)) {
+        current_time = t;
+        if (set_time) set_time(t);
+    }
+
+    if (!writer.send(*connection))
+        dsPrint("ERROR: could not send rollout message to client.\n");
+}
+
+
+/* SAVE: the bodies for RESTORE and the full state for ROLLOUT RESTORE */
+void TCPController::save_user_state(const double time)
+{
+    recordSnapshot(robot, obstacles, &s2_user);
+    user_state.clear();
+    serializeState(robot, obstacles, time, user_state);
+}
+
+/* reply to DEADLINES, formatted like a status message */
+void TCPController::send_deadline_statistics(void)
+{
+    const double values[] = { double(deadline_cycles), double(missed_deadlines), double(max_missed_in_row) };
+    writer.start(binary_mode, binary_protocol::deadlines);
+    writer.append(values, 3);
+
+    if (!writer.send(*connection))
+        dsPrint("ERROR: could not send deadline statistics to client.\n");
+}
+
+/* reply to GETSTATE as binary frame, in both protocols */
+void TCPController::send_state(void)
+{
+    binary_protocol::begin_frame(state_frame, binary_protocol::state);
+    serializeState(robot, obstacles, current_time, state_frame);
+    binary_protocol::end_frame(state_frame);
+
+    if (!connection->send_message(state_frame))
+        dsPrint("ERROR: could not send state to client.\n");
+}
+
+/* the blob follows the command line, its bytes are consumed even if it does not fit */
+void TCPController::parse_set_state(const char* msg)
+{
+    unsigned long size = 0;
+    if (1 != sscanf(msg, "SETSTATE %lu", &size) or size > binary_protocol::max_values * sizeof(double)) {
+        dsPrint("ERROR: bad 'SETSTATE' format: '%s'\n", msg);
+        return;
+    }
+
+    std::string_view blob;
+    if (not connection->get_bytes(size, blob))
+        return; // client is gone, the partial blob is dropped
+
+    double time = current_time;
+    if (restoreState(robot, obstacles, blob, time)) {
+        current_time = time;
+        if (set_time) set_time(time);
+    }
+}
 
 void TCPController::send_robot_description_str()
 {
@@ -528,8 +1260,8 @@ void TCPController::send_robot_description_str()
     dsPrint("Robot description requested.\n");
 
     /* send message to socket */
-    if (!socketServer->send_message(message))
-        dsError("Could not send robot description message to client.\n");
+    if (!connection->send_message(message))
+        dsPrint("ERROR: could not send robot description message to client.\n");
 }
 
 /* fin */
@@ -1,30 +1,63 @@
 #ifndef _TCPCONTROLLER_H_
 #define _TCPCONTROLLER_H_
 
+#include <algorithm>
+#include <array>
+#include <limits>
 #include <draw/drawstuff.h>
 #include <controller/controller.h>
-#include <communication/socketserver.h>
+#include <controller/batch.h>
+#include <communication/transport.h>
+#include <communication/observer.h>
+#include <communication/binary_protocol.h>
+#include <communication/status_writer.h>
+#include <communication/status_compression.h>
 #include <basic/common.h>
+#include <basic/latency_histogram.h>
 #include <basic/constants.h>
 #include <basic/snapshot.h>
+#include <basic/thread_pool.h>
 #include <build/robot.h>
 #include <build/bioloid.h>
 #include <sensors/accelsensor.h>
 #include <misc/camera.h>
 
 
+/* sensor channels of the status message, in order of transmission */
+enum StatusChannel { ch_time, ch_position, ch_velocity, ch_current, ch_accel, ch_body_pos, ch_body_vel, num_status_channels };
+
+/* subscribed index range [first, last) of a sensor channel */
+struct ChannelRange {
+    bool        enabled = true;
+    std::size_t first   = 0;
+    std::size_t last    = std::numeric_limits<std::size_t>::max();
+
+    bool contains(std::size_t idx) const { return enabled and first <= idx and idx < last; }
+    std::size_t begin(std::size_t size) const { return enabled ? std::min(first, size) : 0; }
+    std::size_t end  (std::size_t size) const { return enabled ? std::min(last , size) : 0; }
+};
+
+typedef std::array<ChannelRange, num_status_channels> Subscription;
+
+
 class TCPController : public Controller {
 public:
     TCPController( Configuration& config
-                 , physics const& universe
+                 , physics& universe
                  , Robot& robot
                  , Obstacle& obstacles
                  , Landscape& landscape
-                 , void (*r)()
+                 , std::function<void(double)> r
+                 , std::function<void()> s
                  , Camera& camera )
-    : Controller(universe, robot, obstacles, landscape, r)
+    : Controller(universe, robot, obstacles, landscape, r, s)
     , config(config)
     , camera(camera)
+    , interlaced_mode(not config.pipelined_mode)
+    , pipelined_mode(config.pipelined_mode)
+    , steps_per_control(std::max(1, config.steps_per_control))
+    , deadline_mode(config.deadline_mode and not config.pipelined_mode)
+    , model_id(config.robot)
     {
         dsPrint("Starting TCP controller...");
         if (robot.number_of_joints() < 1)
@@ -33,19 +66,25 @@ public:
 
         dsPrint("Recording initial snapshot.\n");
         recordSnapshot(robot, obstacles, &s1_init);
-        recordSnapshot(robot, obstacles, &s2_user);
+        save_user_state(0.0);
     };
 
     ~TCPController() {
-        delete socketServer;
+        clear_batch();
+        delete connection;
     }
 
     bool control(const double time);
-    bool establishConnection(int port);
+    void send_status(const double time);     // status at the beginning of a cycle (sequential mode)
+    bool handle_commands(const double time); // receive and execute commands until 'DONE'
+    bool has_pending_input(void) const { return connection->has_buffered_data(); }
+    bool establishConnection(Transport* transport);
     void reset();
+    void print_statistics(void) const; // protocol timing, on 'STATS', SIGUSR1 and at exit
+    void set_observer(ObserverBroadcast* o) { observer = o; } // status broadcast, not owned
 
 private:
-    SocketServer *socketServer;
+    Transport *connection = nullptr;
 
     /* functions for command parsing */
     void parse_voltage_UA(const char* msg);
@@ -67,12 +106,57 @@ private:
     bool parse_update_model_command(const char* msg);
     void parse_update_motor_model(const char* msg);
     void parse_toggle_fixed(const char* msg);
+    void set_gravity(bool enable); // of all instances
+    void parse_steps_per_control(const char* msg);
+    void parse_subscription(const char* msg);
+    void reset_derived_sensors(void); // accels and low quality velocities of sensors which were not read
+    void parse_batch(const char* msg);
+    void parse_compression(const char* msg);
+    void parse_solver(const char* msg);
+
+    /* command dispatch */
+    enum CommandResult { next_command, end_of_message, close_connection, unknown_command };
+    CommandResult execute_command(std::string_view msg);
+
+    bool parse_binary_command(void);
+    void parse_rollout(const char* msg);
+
+    void rollout(std::vector<double> const& voltages, const double time, const bool restore);
+
+    /* status broadcast to monitoring clients */
+    ObserverBroadcast* observer = nullptr;
+    unsigned long observed_statuses = 0;
+
+    /* deadline mode (soft real-time) */
+    void next_deadline(void);
+    void send_deadline_statistics(void);
+
+    /* full simulator state as binary blob */
+    void send_state(void);
+    void parse_set_state(const char* msg);
+    std::string state_frame;
 
     void execute_controller();
+    void apply_controls(void); // execute the controllers for the steps of one control period
+    bool start_next_session(void);
+    void set_interlaced_mode(const bool interlaced);
+
+    /* batch mode (vectorized environment) */
+    void create_batch(const unsigned int size, const unsigned int length);
+    void clear_batch(void);
+    void reset_batch(void);
+    double reset_finished_instances(const double time);
+    std::size_t batch_size(void) const { return batch.size() + 1; }
+    Robot& instance_robot(std::size_t k) { return (k == 0) ? robot : batch[k-1]->get_robot(); }
 
     Snapshot s1_init;
     Snapshot s2_user;
+    std::string user_state; // full state of s2_user (joints, accels, time), restored by ROLLOUT RESTORE
+    void save_user_state(const double time);
 
+    void collect_ordered_info(const double time);
+    static std::size_t status_size(Robot const& r) { return 1 + 3 * r.number_of_joints() + 3 * r.number_of_accels() + 6 * r.number_of_bodies(); }
+    void collect_robot_info(Robot& instance, const double time, const double dt);
     void send_ordered_info(const double time);
     void send_robot_configuration(void);
     void send_robot_description_str(void);
@@ -81,9 +165,54 @@ private:
     Configuration& config;
     Camera& camera;
 
+    std::vector<double> status; // values of the last status message
+    StatusWriter writer;        // output buffer of status messages, sized by the traits
+    StatusCompression compression; // quantized delta encoding of binary status frames
+    Subscription subscription;  // sensor channels to be sent
+
     /* by client at run-time changeable flags */
     bool low_quality_sensors = false;
-    bool interlaced_mode = true;
+    bool interlaced_mode;
+    bool binary_mode = false;
+    bool reload_model = false;      // set by 'MODEL', executed at the end of the control message
+    bool model_changed = false;     // 'MODEL' or 'MOTOR' was received, the next client gets a rebuilt robot
+    const bool pipelined_mode;      // step on while the client computes, fixed by configuration
+    static const unsigned int action_delay = 1; // control steps until a reply takes effect, pipelined mode
+    unsigned int unanswered = 0;    // status messages not yet answered by the client
+    bool awaiting_ack = false;      // traits sent, but not confirmed by the client
+    unsigned int steps_per_control; // physics steps per control message (control decimation)
+    unsigned int sensor_steps = 0;  // physics steps since the sensors were read
+    double current_time = 0.0;      // simulation time of the current control step
+
+    /* protocol timing of the control cycle */
+    typedef LatencyHistogram::clock clock;
+    LatencyHistogram think_time;    // status sent until the first byte of the reply arrived
+    LatencyHistogram receive_time;  // first byte until 'DONE' was parsed
+    LatencyHistogram apply_time;    // controls applied and physics stepped until the next status
+    LatencyHistogram send_time;     // status collected, formatted and written
+    clock::time_point status_sent_at;
+    clock::time_point apply_begin;
+    bool status_pending = false;    // status sent, its reply not yet timed
+    bool apply_pending  = false;
+
+    /* deadline mode: fixed control rate, late replies do not stop the physics */
+    const bool deadline_mode;
+    bool reply_overdue = false;     // the deadline of the last status passed, its reply is still read
+    clock::time_point deadline;     // end of the current control period
+    unsigned long deadline_cycles   = 0;
+    unsigned long missed_deadlines  = 0;
+    unsigned long missed_in_row     = 0;
+    unsigned long max_missed_in_row = 0;
+
+    /* model of the robot, to build further batch instances */
+    int model_id;
+    std::vector<double> model_params;
+
+    /* batch of independent worlds, instance 0 is the own robot */
+    std::vector<BatchInstance*> batch;
+    std::vector<unsigned int>   episode_steps;      // control steps since last reset, per instance
+    unsigned int                episode_length = 0; // control steps until auto-reset, 0 = never
+    ThreadPool*                 batch_pool = nullptr;
 };
 
 
@@ -50,8 +50,10 @@ extern "C" {
 #endif
 
 #include "./version.h"
+#ifndef SIMLOID_HEADLESS
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
+#endif
 
 /* texture numbers */
 #define DS_NONE   0	/* uses the current color instead of a texture */
@@ -148,6 +150,18 @@ void glprintf(float x, float y, float z, float line_height, const char* format,
 /* closing bracket for extern "C" */
 #ifdef __cplusplus
 }
+
+#include <stdexcept>
+
+/* Sessions of the multi-session server: while set in a thread, dsError
+   throws DsSessionError instead of exiting, the server closes only the
+   session that failed. */
+extern thread_local bool dsErrorEndsSession;
+
+class DsSessionError : public std::runtime_error {
+public:
+    explicit DsSessionError(const char* what) : std::runtime_error(what) {}
+};
 #endif
 
 #endif
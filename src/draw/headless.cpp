@@ -0,0 +1,95 @@
+// drawstuff without a window, for the headless build (SIMLOID_HEADLESS)
+// messages go to the console, all drawing is dropped
+
+#ifdef SIMLOID_HEADLESS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include <draw/drawstuff.h>
+
+#define KNRM  "\x1B[0m"
+#define KYEL  "\x1B[33m"
+
+//***************************************************************************
+// error handling for unix
+
+static void printMessage (const char *msg1, const char *msg2, va_list ap)
+{
+  fflush (stderr);
+  fflush (stdout);
+  fprintf (stderr,"\n%s: ",msg1);
+  vfprintf (stderr,msg2,ap);
+  fprintf (stderr,"\n");
+  fflush (stderr);
+}
+
+thread_local bool dsErrorEndsSession = false;
+
+extern "C" void dsError (const char *msg, ...)
+{
+  va_list ap;
+  va_start(ap, msg);
+  if (dsErrorEndsSession) {
+    char text[1024];
+    vsnprintf (text,sizeof(text),msg,ap);
+    va_end(ap);
+    throw DsSessionError(text);
+  }
+  printMessage ("Error: ", msg, ap);
+  va_end(ap);
+  exit(EXIT_FAILURE);
+}
+
+extern "C" void dsDebug (const char *msg, ...)
+{
+  va_list ap;
+  va_start (ap,msg);
+  printMessage ("INTERNAL ERROR",msg,ap);
+  va_end(ap);
+  abort();
+}
+
+extern "C" void dsPrint (const char *msg, ...)
+{
+  va_list ap;
+  va_start(ap,msg);
+  printf("%s›››%s", KYEL, KNRM);
+  vprintf(msg,ap);
+  va_end(ap);
+}
+
+//***************************************************************************
+// no window, nothing to draw
+
+extern "C" void dsSimulationLoop (int, char**, int, int, dsFunctions*, int)
+{
+  dsError("simloid was built without graphics.");
+}
+
+extern "C" void dsStop() {}
+
+extern "C" void dsSetViewpoint (float*, float*) {}
+extern "C" void dsGetViewpoint (float xyz[3], float hpr[3])
+{
+  for (int i = 0; i < 3; ++i) xyz[i] = hpr[i] = 0.0f;
+}
+
+extern "C" void dsSetTexture (int) {}
+extern "C" void dsSetColor (float, float, float) {}
+extern "C" void dsSetColorAlpha (float, float, float, float) {}
+
+extern "C" void dsDrawBoxD (const double*, const double*, const double*) {}
+extern "C" void dsDrawSphereD (const double*, const double*, const float) {}
+extern "C" void dsDrawTriangleD (const double*, const double*, const double*, const double*, const double*, int) {}
+extern "C" void dsDrawCylinderD (const double*, const double*, float, float) {}
+extern "C" void dsDrawCappedCylinderD (const double*, const double*, float, float) {}
+extern "C" void dsDrawLineD (const double*, const double*) {}
+
+extern "C" void dsSetSphereQuality (int) {}
+extern "C" void dsSetCappedCylinderQuality (int) {}
+
+extern "C" void glprintf (float, float, float, float, const char*, ...) {}
+
+#endif // SIMLOID_HEADLESS
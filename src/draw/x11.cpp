@@ -59,11 +59,20 @@ static void printMessage (const char *msg1, const char *msg2, va_list ap)
   fflush (stderr);
 }
 
+thread_local bool dsErrorEndsSession = false;
+
 extern "C" void dsError (const char *msg, ...)
 {
   va_list ap;
   va_start(ap, msg);
+  if (dsErrorEndsSession) {
+    char text[1024];
+    vsnprintf (text,sizeof(text),msg,ap);
+    va_end(ap);
+    throw DsSessionError(text);
+  }
   printMessage ("Error: ", msg, ap);
+  va_end(ap);
   exit(EXIT_FAILURE);
 }
 
@@ -72,6 +81,7 @@ extern "C" void dsDebug (const char *msg, ...)
   va_list ap;
   va_start (ap,msg);
   printMessage ("INTERNAL ERROR",msg,ap);
+  va_end(ap);
   abort();
 }
 
@@ -81,6 +91,7 @@ extern "C" void dsPrint (const char *msg, ...)
   va_start(ap,msg);
   printf("%s›››%s", KYEL, KNRM);
   vprintf(msg,ap);
+  va_end(ap);
 }
 
 //***************************************************************************
@@ -17,6 +17,7 @@
 #include <unistd.h>
 #include <cerrno>
 #include <cassert>
+#include <chrono>
 
 #include <draw/drawstuff.h>
 
@@ -29,6 +30,10 @@
 #include <basic/snapshot.h>
 
 #include <controller/tcp_controller.h>
+#include <communication/socketserver.h>
+#include <communication/shmserver.h>
+#include <communication/sessionserver.h>
+#include <communication/session_record.h>
 
 #include <build/bioloid.h>
 #include <build/heightfield.h>
@@ -39,20 +44,24 @@
 
 #include <misc/camera.h>
 
-/* dynamics and objects */
-static physics     universe;
-static Robot       robot(universe.world, universe.space);
-static Obstacle    obstacles(universe.world, universe.space);
-static Landscape   landscape(universe.space);
+/* dynamics and objects, created in main(), since ODE must not
+   be initialized before its own static data (thread local storage) */
+static physics*    universe  = nullptr;
+static Robot*      robot     = nullptr;
+static Obstacle*   obstacles = nullptr;
+static Landscape*  landscape = nullptr;
 static Camera      camera;
 
 /* time and snapshots */
 static double simtime;
+static unsigned int steps_since_timer = 0;
+static unsigned long total_steps = 0;
 static Snapshot s1;
 static Snapshot s2;
 
 /* main loop */
 static bool continueLoop = true;
+static volatile sig_atomic_t statistics_requested = 0; // set by SIGUSR1
 
 /* controller */
 static Controller* controller;
@@ -79,7 +88,7 @@ Configuration global_conf = Configuration();
 static void start(void)
 {
     if (!global_conf.disable_graphics) {
-        camera.set_viewpoint(robot.get_camera_center_obj(), robot.get_camera_setup());
+        camera.set_viewpoint(robot->get_camera_center_obj(), robot->get_camera_setup());
 
         dsPrint("Program controls:\n"
                 "   1: toggle disable/enable graphics\n"
@@ -107,13 +116,13 @@ static void start(void)
 /* stop simulation */
 static void stop() { dsPrint("Exiting simulation.\n"); }
 
-void reset_time(void) { simtime = 0.0; }
+void set_time(double t) { simtime = t; }
 
 static void reset_simulator(void)
 {
-    playSnapshot(robot, obstacles, &s1);
+    playSnapshot(*robot, *obstacles, &s1);
     controller->reset();
-    reset_time();
+    set_time(0.0);
 }
 
 /* called when a key is being pressed */
@@ -127,18 +136,18 @@ static void command(int cmd, bool /*shift*/)
         case 'w': camera.zoom_in ();                                              break;
         case 's': camera.zoom_out();                                              break;
         case 't': camera.toggle_rotate();                                         break;
-        case 'f': camera.toggle_follow(robot.get_camera_center_obj());            break;
-        case '+': robot.set_camera_center_on_next_obj();                          break;
-        case '-': robot.set_camera_center_on_prev_obj();                          break;
-        case 'u': camera.set_viewpoint( robot.get_camera_center_obj()
-                                      , robot.get_camera_setup() );               break;
+        case 'f': camera.toggle_follow(robot->get_camera_center_obj());           break;
+        case '+': robot->set_camera_center_on_next_obj();                         break;
+        case '-': robot->set_camera_center_on_prev_obj();                         break;
+        case 'u': camera.set_viewpoint( robot->get_camera_center_obj()
+                                      , robot->get_camera_setup() );              break;
 
         /* reset */
         case '2': reset_simulator();                                              break;
 
         /* snapshots */
-        case '3': recordSnapshot(robot, obstacles, &s2);                          break;
-        case '4': playSnapshot  (robot, obstacles, &s2);                          break;
+        case '3': recordSnapshot(*robot, *obstacles, &s2);                        break;
+        case '4': playSnapshot  (*robot, *obstacles, &s2);                        break;
 
         /* drawing */
         case '1': global_conf.draw_scene        = !global_conf.draw_scene;        break;
@@ -158,7 +167,7 @@ print_time_statistics(void)
     if (global_conf.draw_scene && !global_conf.disable_graphics)
     {
         const float pos[2] = {-0.98, 0.94};
-        auto const& rp = -robot.bodies[0].get_position().y;
+        auto const& rp = -robot->bodies[0].get_position().y;
 
         glprintf( pos[0], pos[1], 0, 0.02
                 , "time: %5.2lf  sim: %.2lfx %s  fps: %.2lf%s  walking: v=%.2lf m/s  d=%5.2f m"
@@ -180,31 +189,33 @@ print_time_statistics(void)
 static void draw_robot_and_scene()
 {
     /* draw height field */
-    for (unsigned int i = 0; i < landscape.number_of_heightfields(); ++i)
-        landscape.heightfields[i].draw();
+    for (unsigned int i = 0; i < landscape->number_of_heightfields(); ++i)
+        landscape->heightfields[i].draw();
 
     /* draw scene objects and obstacles */
-    for (unsigned int i = 0; i < obstacles.number_of_objects(); ++i)
-        obstacles.objects[i].draw(false);
+    for (unsigned int i = 0; i < obstacles->number_of_objects(); ++i)
+        obstacles->objects[i].draw(false);
+    for (unsigned int i = 0; i < obstacles->number_of_static_objects(); ++i)
+        obstacles->static_objects[i].draw(false);
 
     /* draw the robot */
-    robot.draw(global_conf);
+    robot->draw(global_conf);
 
     /* draw time and velocity information */
     if (global_conf.show_time_stat) print_time_statistics();
 
     /* update camera center of rotation, follow etc. */
-    camera.update(robot.get_camera_center_obj());
+    camera.update(robot->get_camera_center_obj());
 }
 
 
 static void physics_step(void) {
-    dSpaceCollide(universe.space, &universe, &near_callback);  // collision detection
-    dWorldStep(universe.world, global_conf.step_length);       // world simulation step
-    dJointGroupEmpty(universe.contactgroup);                   // remove all contact joints
+    universe->step(global_conf.step_length);
 
     simtime         += global_conf.step_length;                // increase time
     intervalSimTime += global_conf.step_length;
+    ++steps_since_timer;
+    ++total_steps;
     //printf("t: %5.2f\n", simtime);
 }
 
@@ -228,6 +239,11 @@ static void sim_loop(int pause, int singlestep) /**TODO this function is far too
         if (not pause && (controller != nullptr))
             continueLoop = controller->control(simtime);
 
+        if (statistics_requested) {
+            statistics_requested = 0;
+            controller->print_statistics();
+        }
+
         /* Timer */
         if (      global_conf.draw_scene
              and !global_conf.disable_graphics
@@ -236,7 +252,7 @@ static void sim_loop(int pause, int singlestep) /**TODO this function is far too
            )
         {
             current_time = UniTime::getTimeStamp();
-            ref_time = ref_time + uniTimeStepLength;
+            ref_time = ref_time + uniTimeStepLength * (int) steps_since_timer; // controller may run several steps
 
             if (current_time < ref_time) { /* we still have time, so wait until timed out */
                 struct timeval tv{0, (ref_time - current_time).usec};
@@ -249,6 +265,8 @@ static void sim_loop(int pause, int singlestep) /**TODO this function is far too
             }
         }
 
+        steps_since_timer = 0;
+
         current_time = UniTime::getTimeStamp();
         duration = duration * 0.7 + (current_time - start_time) * 0.3;
 
@@ -269,12 +287,12 @@ static void sim_loop(int pause, int singlestep) /**TODO this function is far too
         const double intervalTime = (current_time - intervalBeginRealTime).fseconds();
 
         vel = intervalSimTime / intervalTime;
-        bvel = (intervalSimTime > 0.0001) ? common::dist2D((const double *) dBodyGetPosition(robot.get_camera_center_obj()), camera.lastPos) / intervalSimTime
+        bvel = (intervalSimTime > 0.0001) ? common::dist2D((const double *) dBodyGetPosition(robot->get_camera_center_obj()), camera.lastPos) / intervalSimTime
                                           : 0.0;
 
-        camera.lastPos[0] = dBodyGetPosition(robot.get_camera_center_obj())[0];
-        camera.lastPos[1] = dBodyGetPosition(robot.get_camera_center_obj())[1];
-        camera.lastPos[2] = dBodyGetPosition(robot.get_camera_center_obj())[2];
+        camera.lastPos[0] = dBodyGetPosition(robot->get_camera_center_obj())[0];
+        camera.lastPos[1] = dBodyGetPosition(robot->get_camera_center_obj())[1];
+        camera.lastPos[2] = dBodyGetPosition(robot->get_camera_center_obj())[2];
 
         intervalSimTime = 0.0;
 
@@ -292,6 +310,29 @@ static void sim_loop(int pause, int singlestep) /**TODO this function is far too
     if (not continueLoop) dsPrint("Leaving simulation loop. Shutting down simloid.\n");
 }
 
+/* without graphics there is nothing to pace or draw,
+   physics and controller run back-to-back */
+static void headless_loop(void)
+{
+    start();
+    dsPrint("Graphics disabled, running headless.\n");
+
+    while (continueLoop)
+    {
+        if (not controller->is_paused())
+            physics_step();
+
+        continueLoop = controller->control(simtime);
+
+        if (statistics_requested) {
+            statistics_requested = 0;
+            controller->print_statistics();
+        }
+    }
+    dsPrint("Leaving simulation loop. Shutting down simloid.\n");
+    stop();
+}
+
 
 void
 print_programm_info(std::string executable_name = "")
@@ -318,6 +359,20 @@ print_help(void)
               << "   --notex                         - no textures\n"
               << "   --noshadow(s)                   - no shadows\n"
               << "   --port <port> | -p <port>       - use tcp port number\n"
+              << "   --shm <name>                    - use shared memory instead of tcp\n"
+              << "   --socket <path>                 - use unix domain socket instead of tcp\n"
+              << "   --sessions <threads>            - serve many clients, each with its own world\n"
+              << "   --persistent                    - keep the world and wait for the next client\n"
+              << "                                     when the client disconnects\n"
+              << "   --record <file>                 - record the client's commands to file\n"
+              << "   --replay <file>                 - replay a recorded session as fast as possible\n"
+              << "                                     and report the throughput\n"
+              << "   --observer <port>               - broadcast the status to monitoring clients\n"
+              << "                                     via UDP (see simloid.conf)\n"
+              << "   --deadline                      - soft real-time, step on with the current\n"
+              << "                                     controls when the client is late\n"
+              << "   --pipelined                     - send status right after stepping, controls\n"
+              << "                                     are applied with one step delay\n"
               << "   --steplength <time> | -s <time> - length of one simstep in sec\n"
               << "   --fps [<fps>|off]               - frames per second in 1/sec or 'off'\n"
               << "                                     'off' means, each simstep is drawn\n"
@@ -384,6 +439,96 @@ readOptions (int argc, char* argv[])
                 ++i;
             }
         }
+        else if (strncmp(argv[i], "--shm", 5) == 0)
+        {
+            if (argc < i+2)
+            {
+                dsPrint("usage: %s --shm <name>\n", argv[0]);
+                exit(0);
+            }
+            else
+            {
+                global_conf.shm_name = argv[i+1];
+                ++i;
+            }
+        }
+        else if (strncmp(argv[i], "--socket", 8) == 0)
+        {
+            if (argc < i+2)
+            {
+                dsPrint("usage: %s --socket <path>\n", argv[0]);
+                exit(0);
+            }
+            else
+            {
+                global_conf.socket_path = argv[i+1];
+                ++i;
+            }
+        }
+        else if (strncmp(argv[i], "--sessions", 10) == 0)
+        {
+            if (argc < i+2)
+            {
+                dsPrint("usage: %s --sessions <number_of_threads>\n", argv[0]);
+                exit(0);
+            }
+            else
+            {
+                global_conf.session_threads = atoi(argv[i+1]);
+                ++i;
+            }
+        }
+        else if (strncmp(argv[i], "--persistent", 12) == 0)
+        {
+            global_conf.persistent_server = true;
+        }
+        else if (strncmp(argv[i], "--record", 8) == 0)
+        {
+            if (argc < i+2)
+            {
+                dsPrint("usage: %s --record <file>\n", argv[0]);
+                exit(0);
+            }
+            else
+            {
+                global_conf.record_file = argv[i+1];
+                ++i;
+            }
+        }
+        else if (strncmp(argv[i], "--replay", 8) == 0)
+        {
+            if (argc < i+2)
+            {
+                dsPrint("usage: %s --replay <file>\n", argv[0]);
+                exit(0);
+            }
+            else
+            {
+                global_conf.replay_file = argv[i+1];
+                ++i;
+            }
+        }
+        else if (strncmp(argv[i], "--observer", 10) == 0)
+        {
+            if (argc < i+2)
+            {
+                dsPrint("usage: %s --observer <port>\n", argv[0]);
+                exit(0);
+            }
+            else
+            {
+                global_conf.observer_port = atoi(argv[i+1]);
+                ++i;
+            }
+        }
+        else if (strncmp(argv[i], "--deadline", 10) == 0)
+        {
+            global_conf.deadline_mode = true;
+        }
+        else if (strncmp(argv[i], "--pipelined", 11) == 0)
+        {
+            global_conf.pipelined_mode = true;
+        }
         else if ((strncmp(argv[i], "--steplength", 12) == 0) || (strncmp(argv[i], "-s", 2) == 0))
         {
             if (argc < i+2)
@@ -445,6 +590,44 @@ readOptions (int argc, char* argv[])
     }
 }
 
+static Transport*
+create_transport(void)
+{
+    if (not global_conf.shm_name.empty())
+        return new SharedMemoryServer(global_conf.shm_name, continueLoop);
+    if (not global_conf.socket_path.empty())
+        return new SocketServer(global_conf.socket_path);
+    return new SocketServer(global_conf.tcp_port);
+}
+
+/* serve many clients in one process, each gets its own world, no graphics */
+static int
+run_session_server(void)
+{
+    /* sessions are stepped by the client's messages, a worker reads a message until it is complete */
+    if (global_conf.pipelined_mode)
+        dsError("Pipelined mode is not supported with multiple sessions.\n");
+    if (global_conf.deadline_mode)
+        dsError("Deadline mode is not supported with multiple sessions.\n");
+
+    if (not global_conf.shm_name.empty())
+        dsPrint("Warning: shared memory is not supported with multiple sessions, using sockets.\n");
+    if (not global_conf.record_file.empty())
+        dsPrint("Warning: recording is not supported with multiple sessions.\n");
+    if (global_conf.observer_port > 0)
+        dsPrint("Warning: observers are not supported with multiple sessions.\n");
+
+    global_conf.disable_graphics = true;
+    global_conf.draw_scene = false;
+
+    SocketServer* listener = global_conf.socket_path.empty() ? new SocketServer(global_conf.tcp_port)
+                                                             : new SocketServer(global_conf.socket_path);
+    SessionServer server(global_conf, listener, global_conf.session_threads);
+    if (not server.run(continueLoop))
+        dsError("Could not start session server.\n");
+
+    return 0;
+}
 
 void
 sigtest(int sig)
@@ -452,6 +635,7 @@ sigtest(int sig)
     switch (sig) {
         case SIGTERM: dsPrint("Received SIGTERM.\n"); continueLoop = false; break;
         case SIGINT:  dsPrint("Received SIGINT. \n"); continueLoop = false; break;
+        case SIGUSR1: statistics_requested = 1; break; // printed by the simulation loop
         default:      dsPrint("Received unknown signal: %d\n", sig);
     }
 }
@@ -471,6 +655,28 @@ main(int argc, char **argv)
     /* set signal handler */
     Signals signal(sigtest);
 
+    /* a replay takes the settings of the recording and runs at maximal speed */
+    ReplayTransport* replay = nullptr;
+    if (not global_conf.replay_file.empty())
+    {
+        replay = new ReplayTransport();
+        if (not replay->load(global_conf.replay_file))
+            dsError("Could not load session record.\n");
+
+        replay->apply_settings(global_conf);
+        global_conf.disable_graphics = true;
+        global_conf.real_time        = false;
+        global_conf.session_threads  = 0;
+        global_conf.record_file.clear();
+    }
+
+    if (global_conf.session_threads > 0)
+        return run_session_server();
+
+#ifdef SIMLOID_HEADLESS
+    global_conf.disable_graphics = true; // built without X11 and OpenGL
+#endif
+
     /* setup pointers to drawstuff callback functions */
     dsFunctions fn;
     fn.version          = DS_VERSION;
@@ -487,22 +693,66 @@ main(int argc, char **argv)
     global_conf.draw_scene = !global_conf.disable_graphics;
     /** so actually disable_graphics and draw_scene mean the same thing*/
 
+    /* create world, ODE stays initialized until the end */
+    dInitODE();
+    universe  = new physics();
+    robot     = new Robot(universe->world, universe->space);
+    obstacles = new Obstacle(universe->world, universe->space, universe->static_space);
+    landscape = new Landscape(universe->static_space);
+
     /* create Robot */
-    Bioloid::create_robot(robot);
-    Bioloid::create_scene(obstacles, landscape);
+    Bioloid::create_robot(*robot);
+    Bioloid::create_scene(*obstacles, *landscape);
+    universe->fit_space(global_conf);
 
     /* create TCP Controller */
-    controller = new TCPController(global_conf, universe, robot, obstacles, landscape, reset_time, camera);
-    if (((TCPController*)controller)->establishConnection(global_conf.tcp_port))
+    controller = new TCPController(global_conf, *universe, *robot, *obstacles, *landscape, set_time, physics_step, camera);
+
+    Transport* transport = replay ? replay : create_transport();
+    SessionRecorder recorder;
+    if (not global_conf.record_file.empty())
+    {
+        if (not recorder.open(global_conf.record_file, global_conf))
+            dsError("Could not create session record.\n");
+        transport->record_to(&recorder);
+    }
+
+    ObserverBroadcast observer;
+    if (global_conf.observer_port > 0)
+    {
+        if (not observer.open(global_conf.observer_address, global_conf.observer_port))
+            dsError("Could not start observer broadcast.\n");
+        ((TCPController*)controller)->set_observer(&observer);
+    }
+
+    const auto loop_begin = std::chrono::steady_clock::now();
+    if (((TCPController*)controller)->establishConnection(transport))
     {
         /* run simulation */
-        bool initial_pause = global_conf.initial_pause && !global_conf.disable_graphics;
-        dsSimulationLoop(argc, argv, global_conf.window_width, global_conf.window_height, &fn, (int) initial_pause);
+        if (global_conf.disable_graphics)
+            headless_loop();
+        else
+            dsSimulationLoop(argc, argv, global_conf.window_width, global_conf.window_height, &fn, (int) global_conf.initial_pause);
     }
     else dsError("Could not start TCP controller.\n");
+    const double loop_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loop_begin).count();
+
+    if (replay)
+        dsPrint( "Replayed %lu steps in %.3f s: %.0f steps/s, %.1fx the recorded session.\n"
+                 "   received %lu bytes, sent %lu bytes\n"
+               , total_steps, loop_seconds, total_steps / loop_seconds
+               , replay->recorded_seconds() / loop_seconds
+               , replay->received(), replay->sent() );
+    controller->print_statistics();
 
     /* clean up simulation */
     delete controller;
+    delete landscape;
+    delete obstacles;
+    delete robot;
+    delete universe;
+    dsPrint("Closing ODE.\n");
+    dCloseODE();
 
     return 0;
 }
@@ -31,6 +31,7 @@ void
 create_wildcat_0(Robot& robot)
 {
     dsPrint("Wildcat_0 (four-legged)\n");
+    robot.set_self_collision(true); // the limbs can touch each other
     double xpos, ypos, zpos;
 
     /* body */
@@ -102,6 +103,7 @@ void
 create_wildcat_1(Robot& robot) /* alternative roll joints */
 {
     dsPrint("Wildcat_1 (four-legged)\n");
+    robot.set_self_collision(true); // the limbs can touch each other
     double xpos, ypos, zpos;
 
     /* body */
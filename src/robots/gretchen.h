@@ -33,6 +33,7 @@ void
 create_gretchen0(Robot& robot, std::vector<double> /*model_parameter*/)
 {
     dsPrint("Creating Gretchen...");
+    robot.set_self_collision(true); // the limbs can touch each other
     const double friction = constants::friction::hi;
 
     /* shortening knees!! */
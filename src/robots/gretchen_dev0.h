@@ -158,6 +158,7 @@ namespace Gretchen {
 void
 create_grt_dev0_rnd(Robot& robot, std::vector<double> model_parameter)
 {
+    robot.set_self_collision(true); // the limbs can touch each other
     unsigned rnd_instance = 0;
     double   rnd_amp = .0;
     //double   growth = 1.0;
@@ -42,6 +42,7 @@ void
 create_hannah_0(Robot& robot)
 {
     dsPrint("Creating Hannah <3 \n");
+    robot.set_self_collision(true); // the limbs can touch each other
     double xpos, ypos, zpos;
 
     /* body */
@@ -114,6 +115,7 @@ void
 create_hannah_1(Robot& robot)
 {
     dsPrint("Creating Hannah <3 \n");
+    robot.set_self_collision(true); // the limbs can touch each other
     double xpos, ypos, zpos;
 
     /* body */
@@ -186,6 +188,7 @@ void
 create_hannah_2(Robot& robot)
 {
     dsPrint("Creating Hannah <3 \n");
+    robot.set_self_collision(true); // the limbs can touch each other
     double xpos, ypos, zpos;
 
     /* body */
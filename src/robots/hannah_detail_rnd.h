@@ -190,6 +190,7 @@ void create_leg(Robot& robot, HannahMorphology const& m, Vector3 pos, std::strin
 void
 create_hannah_detail_random(Robot& robot, std::vector<double> model_parameter)
 {
+    robot.set_self_collision(true); // the limbs can touch each other
     unsigned rnd_instance = 0;
     double   rnd_amp = .0;
     double   growth = 1.0;
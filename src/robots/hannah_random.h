@@ -94,6 +94,7 @@ namespace HannahRand {
 void
 create_random_hannah(Robot& robot, std::vector<double> model_parameter)
 {
+    robot.set_self_collision(true); // the limbs can touch each other
     unsigned rnd_instance = 0;
     double   rnd_amp = .0;
 
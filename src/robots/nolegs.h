@@ -11,6 +11,7 @@ namespace Nolegs {
 void create_worm(Robot& robot)
 {
     dsPrint("WORM\n");
+    robot.set_self_collision(true); // the segments can touch each other
 
     const double L = .1;
     const double B = .025;
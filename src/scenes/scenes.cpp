@@ -19,7 +19,7 @@ Scenes::create_hurdles(Obstacle& obstacles)
         len.z = 0.002*i;
         pos.y = -1.0*i - 0.5; // remember: -i (unsigned!) => very large => kills ODE
         pos.z = 0.5*len.z + 0.001;
-        obstacles.create_fixed_box("", pos, len, .0, constants::materials::rock, colors::white, friction);
+        obstacles.create_static_box(pos, len, colors::white, friction);
     }
 }
 
@@ -75,7 +75,7 @@ Scenes::create_stairways(Obstacle& obstacles)
         len.z  = stepsize;
         pos.z += 2*len.z;// + 0.0005*i;
         len.x  = 0.8 + i*0.05;
-        obstacles.create_fixed_box("", pos, len, .0, constants::materials::rock, colors::white, friction);
+        obstacles.create_static_box(pos, len, colors::white, friction);
     }
 
 }
@@ -1,6 +1,6 @@
 #include <sensors/accelsensor.h>
 
-const Vector3 AccelSensor::update(void)
+const Vector3 AccelSensor::update(const double dt)
 {
     /* get current velocity */
     const Vector3 current_velocity(dBodyGetLinearVel(body_id));
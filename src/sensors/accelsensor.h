@@ -12,8 +12,6 @@
 #include <basic/configuration.h>
 
 
-extern Configuration global_conf;
-
 //TODO make to const Vector3
 class axis_direction {
 public:
@@ -36,7 +34,6 @@ class AccelSensor
 public:
     AccelSensor(const dBodyID b, const axis_direction d0, const axis_direction d1, const axis_direction d2)
     : body_id(b)
-    , dt(global_conf.step_length)
     , gravity(.0, .0, -constants::gravity)
     , acceleration(.0)
     , last_velocity(dBodyGetLinearVel(body_id))
@@ -49,7 +46,7 @@ public:
         }
     };
 
-    const Vector3 update(void);
+    const Vector3 update(const double dt); // dt: time since the last update
 
     void reset() {
         last_velocity = dBodyGetLinearVel(body_id);
@@ -57,9 +54,11 @@ public:
     }
     void draw(void);
 
+    Vector3 const& get_last_velocity(void) const { return last_velocity; }
+    void set_last_velocity(Vector3 const& v) { last_velocity = v; }
+
 protected:
     dBodyID body_id;       // body to measure acceleration
-    const double dt;       // timestep
     const Vector3 gravity;
     Vector3 acceleration;
     Vector3 last_velocity;